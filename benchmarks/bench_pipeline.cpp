@@ -45,7 +45,8 @@ static void BM_PipelineThroughput(benchmark::State& state) {
     for (auto _ : state) {
         state.PauseTiming();
         // Top-level task to manage the pipelines
-        auto benchmark_task = [concurrency, depth](auto, auto& state) -> coflux::task<void, PipelineExecutor, PipelineScheduler> {
+        // Arguments instead of captures: the lambda objects are gone once the coroutines first suspend.
+        auto benchmark_task = [](auto, auto& state, int concurrency, int depth) -> coflux::task<void, PipelineExecutor, PipelineScheduler> {
             auto&& ctx = co_await coflux::context();
             std::vector<coflux::fork<long long, PipelineExecutor>> pipeline_final_stages;
             pipeline_final_stages.reserve(concurrency);
@@ -58,7 +59,7 @@ static void BM_PipelineThroughput(benchmark::State& state) {
                 // We only need to co_await the *final* stage result eventually
                 // The intermediate stages are awaited internally
                 pipeline_final_stages.push_back(
-                    [depth](auto&& ctx, int initial_value, long long count) -> coflux::fork<long long, PipelineExecutor> {
+                    [](auto&& ctx, int initial_value, long long count, int depth) -> coflux::fork<long long, PipelineExecutor> {
                         long long final_result = 0;
                         for (long long k = 0; k < count; ++k) {
                             // Keep launching the first stage to push items through
@@ -67,7 +68,7 @@ static void BM_PipelineThroughput(benchmark::State& state) {
                             );
                         }
                         co_return final_result; // Return result of last item for simplicity
-                    }(ctx, i, items_per_pipeline)
+                    }(ctx, i, items_per_pipeline, depth)
                     );
             }
 
@@ -79,7 +80,7 @@ static void BM_PipelineThroughput(benchmark::State& state) {
             // For throughput, we let the task destructor handle the join
             co_return;
 
-            }(env, state); // Launch the benchmark task
+            }(env, state, concurrency, depth); // Launch the benchmark task
 
         benchmark_task.join(); // Wait for the entire batch to complete
         
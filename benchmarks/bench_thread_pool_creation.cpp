@@ -123,6 +123,48 @@ BENCHMARK(BM_MtoNThreadPool_ForkCreationAndDestructionFinalOneTime)
     ->UseRealTime()
     ->MinWarmUpTime(3.0);
 
+coflux::fork<void, pool> busy_fork(auto&&, int spins) {
+    for (int i = 0; i < spins; ++i) {
+        benchmark::DoNotOptimize(i);
+    }
+    co_return;
+}
+
+coflux::task<void, pool> skewed_producer(auto env, long long forks_to_create) {
+    for (long long i = 0; i < forks_to_create; ++i) {
+        busy_fork(co_await coflux::context(), 200);
+    }
+}
+
+// Only `producers` of the workers create forks, the other workers get their work by stealing.
+static void BM_ThreadPool_SkewedProducersSteal(benchmark::State& state) {
+    for (auto _ : state) {
+        auto env = coflux::make_environment(sche{});
+
+        auto test_task = [](auto, auto& state) -> coflux::task<void, pool> {
+            const long long M         = state.range(0);
+            const long long producers = state.range(1);
+            std::vector<coflux::task<void, pool>> producer_tasks(producers);
+
+            for (auto& t : producer_tasks)
+                t = skewed_producer(co_await coflux::spawn_environment<sche>(), M / producers);
+            co_await coflux::when(std::move(producer_tasks));
+
+            }(env, state);
+
+        test_task.join();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ThreadPool_SkewedProducersSteal)
+    ->Args({ 100000,  1 })
+    ->Args({ 1000000, 1 })
+    ->Args({ 100000,  2 })
+    ->Args({ 1000000, 2 })
+    ->UseRealTime()
+    ->MinWarmUpTime(1.0);
+
 /*
 ------------------------------------------------------------------------------------------------------------------------------------------------------------
 Benchmark                                                                                                  Time             CPU   Iterations UserCounters...
@@ -0,0 +1,70 @@
+#include <benchmark/benchmark.h>
+#include <coflux/task.hpp>
+#include <coflux/executor.hpp>
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+using pool = coflux::thread_pool_executor<>;
+using sche = coflux::scheduler<pool>;
+using clock_type = std::chrono::steady_clock;
+
+// Leaves the pool alone and reports how much CPU its idle workers burn, relative to one core.
+static void BM_ThreadPool_IdleCpu(benchmark::State& state) {
+    auto env = coflux::make_environment(sche{});
+    const auto idle_time = std::chrono::milliseconds(state.range(0));
+    double cpu_percent = 0;
+
+    for (auto _ : state) {
+        std::clock_t cpu_begin  = std::clock();
+        auto         wall_begin = clock_type::now();
+        std::this_thread::sleep_for(idle_time);
+        std::clock_t cpu_end  = std::clock();
+        auto         wall_end = clock_type::now();
+
+        double cpu_seconds  = double(cpu_end - cpu_begin) / CLOCKS_PER_SEC;
+        double wall_seconds = std::chrono::duration<double>(wall_end - wall_begin).count();
+        cpu_percent = 100.0 * cpu_seconds / wall_seconds;
+    }
+    state.counters["idle_cpu_percent"] = cpu_percent;
+}
+
+BENCHMARK(BM_ThreadPool_IdleCpu)
+    ->Arg(200)
+    ->Iterations(5)
+    ->UseRealTime();
+
+// Submits one task to a pool whose workers have gone to sleep and measures how long it takes to start running.
+static void BM_ThreadPool_WakeLatency(benchmark::State& state) {
+    auto env = coflux::make_environment(sche{});
+    const auto settle_time = std::chrono::microseconds(state.range(0));
+    std::vector<double> samples;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::this_thread::sleep_for(settle_time);
+        clock_type::time_point resumed_at;
+        state.ResumeTiming();
+
+        auto submitted_at = clock_type::now();
+        auto t = [](auto, clock_type::time_point& resumed_at) -> coflux::task<void, pool> {
+            resumed_at = clock_type::now();
+            co_return;
+            }(env, resumed_at);
+        t.join();
+
+        samples.push_back(std::chrono::duration<double, std::micro>(resumed_at - submitted_at).count());
+    }
+
+    std::sort(samples.begin(), samples.end());
+    state.counters["p50_us"] = samples[samples.size() / 2];
+    state.counters["p99_us"] = samples[samples.size() * 99 / 100];
+}
+
+BENCHMARK(BM_ThreadPool_WakeLatency)
+    ->Arg(100)
+    ->Arg(2000)
+    ->Iterations(2000)
+    ->UseRealTime();
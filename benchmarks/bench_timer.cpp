@@ -0,0 +1,130 @@
+#include <benchmark/benchmark.h>
+#include <coflux/task.hpp>
+#include <coflux/executor.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using timer = coflux::timer_executor;
+using clock_type = std::chrono::steady_clock;
+
+static timer make_timer(benchmark::State& state) {
+    return timer(state.range(0) ? coflux::concurrent::timer_backend::wheel : coflux::concurrent::timer_backend::heap);
+}
+
+// Parks `pending` timers an hour out, so every measured submit or expiry happens next to them.
+static void fill_pending(timer& t, std::size_t pending) {
+    for (std::size_t i = 0; i < pending; i++) {
+        t.execute([] {}, std::chrono::hours(1) + std::chrono::milliseconds(i % 4096));
+    }
+}
+
+// Submits far timers one after another on top of the pending ones.
+static void BM_Timer_Submit(benchmark::State& state) {
+    timer t = make_timer(state);
+    fill_pending(t, std::size_t(state.range(1)));
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        t.execute([] {}, std::chrono::minutes(30) + std::chrono::milliseconds(i++ % 4096));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Timer_Submit)
+    ->ArgNames({ "wheel", "pending" })
+    ->Args({ 0, 0 })
+    ->Args({ 1, 0 })
+    ->Args({ 0, 1 << 20 })
+    ->Args({ 1, 1 << 20 })
+    ->Iterations(1 << 20)
+    ->UseRealTime();
+
+// Submits batches of short timers and reports how late they fire, relative to their deadline.
+static void BM_Timer_Jitter(benchmark::State& state) {
+    timer t = make_timer(state);
+    fill_pending(t, std::size_t(state.range(1)));
+    // Lets the timer thread take in the pending timers before anything is measured.
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    constexpr std::size_t batch = 256;
+    const auto delay = std::chrono::milliseconds(5);
+    std::vector<double> samples;
+    std::size_t round = 0;
+
+    for (auto _ : state) {
+        // Shifts every batch against the wheel's tick, back-to-back batches would otherwise always start right after one.
+        std::this_thread::sleep_for(std::chrono::microseconds(317 * round++ % 1000));
+        std::vector<clock_type::time_point> deadlines(batch), fired(batch);
+        std::atomic_size_t remaining = batch;
+        for (std::size_t i = 0; i < batch; i++) {
+            deadlines[i] = clock_type::now() + delay;
+            t.execute([&fired, &remaining, i] {
+                fired[i] = clock_type::now();
+                remaining.fetch_sub(1, std::memory_order_release);
+                }, delay);
+        }
+        while (remaining.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        for (std::size_t i = 0; i < batch; i++) {
+            samples.push_back(std::chrono::duration<double, std::micro>(fired[i] - deadlines[i]).count());
+        }
+    }
+
+    std::sort(samples.begin(), samples.end());
+    state.counters["p50_us"] = samples[samples.size() / 2];
+    state.counters["p99_us"] = samples[samples.size() * 99 / 100];
+}
+
+BENCHMARK(BM_Timer_Jitter)
+    ->ArgNames({ "wheel", "pending" })
+    ->Args({ 0, 0 })
+    ->Args({ 1, 0 })
+    ->Args({ 0, 1 << 20 })
+    ->Args({ 1, 1 << 20 })
+    ->Iterations(50)
+    ->UseRealTime();
+
+template <typename Executor>
+using sleeper = coflux::task<void, Executor, coflux::scheduler<Executor, timer>>;
+
+template <typename Executor>
+static sleeper<Executor> sleep_once(auto, clock_type::time_point deadline, clock_type::time_point& woke) {
+    co_await coflux::this_task::sleep_until(deadline);
+    woke = clock_type::now();
+}
+
+// One coroutine sleeping until `range(0)` microseconds from now, the counters are the distribution of
+// actual minus requested wake time. On the pool the worker's own timers fire it, on noop_executor the timer thread does.
+template <typename Executor>
+static void BM_Sleep_Jitter(benchmark::State& state) {
+    auto env = coflux::make_environment(coflux::scheduler<Executor, timer>{});
+    const auto request = std::chrono::microseconds(state.range(0));
+    std::vector<double> samples;
+
+    for (auto _ : state) {
+        auto deadline = clock_type::now() + request;
+        clock_type::time_point woke;
+        sleep_once<Executor>(env, deadline, woke).join();
+        samples.push_back(std::chrono::duration<double, std::micro>(woke - deadline).count());
+    }
+
+    std::sort(samples.begin(), samples.end());
+    state.counters["p50_us"] = samples[samples.size() / 2];
+    state.counters["p99_us"] = samples[samples.size() * 99 / 100];
+    state.counters["max_us"] = samples.back();
+}
+
+BENCHMARK(BM_Sleep_Jitter<coflux::thread_pool_executor<>>)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Iterations(2000)
+    ->UseRealTime();
+
+BENCHMARK(BM_Sleep_Jitter<coflux::noop_executor>)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Iterations(2000)
+    ->UseRealTime();
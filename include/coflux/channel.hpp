@@ -122,11 +122,20 @@ namespace coflux {
 			channel_write_awaiter& operator=(channel_write_awaiter&&)	   = default;
 
 			bool await_ready() noexcept {
-				return this->channel_->Try_write(this->value_, this->success_flag_);
+				if (!this->channel_->Try_write(this->value_, this->success_flag_)) {
+					return false;
+				}
+				budget_spent_ = !concurrent::coop_budget::consume();
+				return !budget_spent_;
 			}
 
 			void await_suspend(std::coroutine_handle<> handle) {
 				suspend_base::await_suspend();
+				if (budget_spent_) {
+					// Already written, only re-queued to let the worker run something else.
+					suspend_base::execute(handle);
+					return;
+				}
 				handle_ = handle;
 				this->channel_->Push_writer(channel_awaiter_proxy(this));
 			}
@@ -142,6 +151,7 @@ namespace coflux {
 			}
 
 			std::coroutine_handle<> handle_;
+			bool                    budget_spent_ = false;
 		};
 
 		template <typename Channel>
@@ -194,11 +204,20 @@ namespace coflux {
 			channel_read_awaiter& operator=(channel_read_awaiter&&)      = default;
 
 			bool await_ready() noexcept {
-				return this->channel_->Try_read(this->value_, this->success_flag_);
+				if (!this->channel_->Try_read(this->value_, this->success_flag_)) {
+					return false;
+				}
+				budget_spent_ = !concurrent::coop_budget::consume();
+				return !budget_spent_;
 			}
 
 			void await_suspend(std::coroutine_handle<> handle) {
 				suspend_base::await_suspend();
+				if (budget_spent_) {
+					// Already read, only re-queued to let the worker run something else.
+					suspend_base::execute(handle);
+					return;
+				}
 				handle_ = handle;
 				this->channel_->Push_reader(channel_awaiter_proxy(this));
 			}
@@ -214,6 +233,7 @@ namespace coflux {
 			}
 
 			std::coroutine_handle<> handle_;
+			bool                    budget_spent_ = false;
 		};
 	}
 
@@ -9,6 +9,14 @@
 
 namespace coflux {
     namespace detail {
+        // A cancelled task carries no exception of its own.
+        template <typename BasicTaskResult>
+        std::exception_ptr Error_of(BasicTaskResult& basic_task_result) {
+            return basic_task_result.get_status().load(std::memory_order_acquire) == cancelled
+                ? std::make_exception_ptr(cancel_exception(false))
+                : std::move(basic_task_result).error();
+        }
+
         template <task_like...TaskLikes>
         struct when_any_closure : public awaitable_closure<when_any_closure<TaskLikes...>> {
             using task_type = std::tuple<TaskLikes...>;
@@ -77,7 +85,7 @@ namespace coflux {
                         if (basic_task_result.get_status().load(std::memory_order_acquire) != completed)
                             COFLUX_ATTRIBUTES(COFLUX_UNLIKELY) 
                         {
-                            std::exception_ptr e = std::move(basic_task_result).error();
+                            std::exception_ptr e = Error_of(basic_task_result);
                             if (basic_task_result.get_status().exchange(handled) != handled) {
                                 error_ = e;
                             }
@@ -109,7 +117,7 @@ namespace coflux {
                         if (basic_task_result.get_status().load(std::memory_order_acquire) != completed)
                             COFLUX_ATTRIBUTES(COFLUX_UNLIKELY) 
                         {
-                            std::exception_ptr e = std::move(basic_task_result).error();
+                            std::exception_ptr e = Error_of(basic_task_result);
                             if (basic_task_result.get_status().exchange(handled) != handled) {
                                 error_ = e;
                             }
@@ -257,7 +265,7 @@ namespace coflux {
                     {
                         std::lock_guard<std::mutex> lock(mtx_);
                         if (!error_) {
-                            std::exception_ptr e = std::move(basic_task_result).error();
+                            std::exception_ptr e = Error_of(basic_task_result);
                             if (basic_task_result.get_status().exchange(handled) != handled) {
                                 error_ = e;
                             }
@@ -291,7 +299,7 @@ namespace coflux {
                     {
                         std::lock_guard<std::mutex> lock(mtx_);
                         if (!error_) {
-                            std::exception_ptr e = std::move(basic_task_result).error();
+                            std::exception_ptr e = Error_of(basic_task_result);
                             if (basic_task_result.get_status().exchange(handled) != handled) {
                                 error_ = e;
                             }
@@ -476,7 +484,7 @@ namespace coflux {
                             if (basic_task_result.get_status().load(std::memory_order_acquire) != completed)
                                 COFLUX_ATTRIBUTES(COFLUX_UNLIKELY) {
                                 if (!error_) {
-                                    std::exception_ptr e = std::move(basic_task_result).error();
+                                    std::exception_ptr e = Error_of(basic_task_result);
                                     if (basic_task_result.get_status().exchange(handled) != handled) {
                                         error_ = e;
                                     }
@@ -526,7 +534,7 @@ namespace coflux {
                             if (basic_task_result.get_status().load(std::memory_order_acquire) != completed)
                                 COFLUX_ATTRIBUTES(COFLUX_UNLIKELY) {
                                 if (!error_) {
-                                    std::exception_ptr e = std::move(basic_task_result).error();
+                                    std::exception_ptr e = Error_of(basic_task_result);
                                     if (basic_task_result.get_status().exchange(handled) != handled) {
                                         error_ = e;
                                     }
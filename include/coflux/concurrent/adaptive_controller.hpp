@@ -0,0 +1,158 @@
+#if defined(_MSC_VER) && _MSC_VER > 1000 || defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 3)
+#pragma once
+#endif
+
+#ifndef COFLUX_ADAPTIVE_CONTROLLER_HPP
+#define COFLUX_ADAPTIVE_CONTROLLER_HPP
+
+#include "../detail/forward_declaration.hpp"
+
+namespace coflux {
+	namespace concurrent {
+		// Counters of one worker, only written by that worker.
+		struct adaptive_sample {
+			static void add(std::atomic_size_t& counter, std::size_t n = 1) noexcept {
+				counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+			}
+
+			std::atomic_size_t refills         = 0;	// refills that moved anything out of a global queue
+			std::atomic_size_t refilled        = 0;	// handles moved
+			std::atomic_size_t refill_capacity = 0;	// handles we asked for in those refills
+			std::atomic_size_t steal_tries     = 0;
+			std::atomic_size_t steals          = 0;
+			std::atomic_size_t spins           = 0;	// spin phases before parking
+			std::atomic_size_t spin_hits       = 0;	// spin phases which found work
+		};
+
+		template <typename ConstantTraits>
+		class adaptive_controller {
+		public:
+			/*
+			*			Every `period` one worker folds all adaptive_samples and adjusts three knobs:
+			*			- spin_budget:    doubled while most spin phases find work, halved while few do.
+			*			- batch_size:     halved while thieves keep splitting our batches, doubled while
+			*			                  refills come back full and nobody needs to steal.
+			*			- grow_threshold: backlog per thread before cached mode adds a thread. Lowered while the
+			*			                  estimated queueing delay (backlog / drain rate) is above target, raised
+			*			                  while it is far below.
+			*/
+			using constant_traits = ConstantTraits;
+
+			static constexpr std::size_t max_batch_size     = constant_traits::WORKSTEAL_LOCAL_QUEUE_CAPACITY;
+			static constexpr std::size_t max_spin_budget    = 256;
+			static constexpr std::size_t min_grow_threshold = 1;
+			static constexpr std::size_t max_grow_threshold = 1024;
+
+			static constexpr std::chrono::microseconds period         = std::chrono::microseconds(constant_traits::ADAPTIVE_PERIOD_MICROSECONDS);
+			static constexpr std::chrono::microseconds target_latency = std::chrono::microseconds(constant_traits::ADAPTIVE_TARGET_LATENCY_MICROSECONDS);
+
+		public:
+			// Also the fixed backlog per thread of a pool that runs without the controller.
+			static constexpr std::size_t initial_grow_threshold = 32;
+
+			adaptive_controller()  = default;
+			~adaptive_controller() = default;
+
+			adaptive_controller(const adaptive_controller&)            = delete;
+			adaptive_controller(adaptive_controller&&)                 = delete;
+			adaptive_controller& operator=(const adaptive_controller&) = delete;
+			adaptive_controller& operator=(adaptive_controller&&)      = delete;
+
+			std::size_t batch_size() const noexcept {
+				return batch_size_.load(std::memory_order_relaxed);
+			}
+
+			std::size_t spin_budget() const noexcept {
+				return spin_budget_.load(std::memory_order_relaxed);
+			}
+
+			std::size_t grow_threshold() const noexcept {
+				return grow_threshold_.load(std::memory_order_relaxed);
+			}
+
+			// Cheap unless a period has passed, then the first caller does the update.
+			template <typename Threads, typename TaskQueues>
+			void maybe_update(Threads& threads, TaskQueues& task_queues) {
+				auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+				if (now < next_update_.load(std::memory_order_relaxed)) COFLUX_ATTRIBUTES(COFLUX_LIKELY) {
+					return;
+				}
+				if (updating_.exchange(true, std::memory_order_acquire)) {
+					return;
+				}
+				// the first round only has counters, no interval to measure a rate over
+				auto elapsed = std::chrono::steady_clock::duration(last_update_ ? now - last_update_ : 0);
+				last_update_ = now;
+				next_update_.store(now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(period).count(),
+					std::memory_order_relaxed);
+				std::size_t backlog = 0;
+				for (auto& queue : task_queues) {
+					backlog += queue->size_approx();
+				}
+				Update(threads, backlog, elapsed);
+				updating_.store(false, std::memory_order_release);
+			}
+
+		private:
+			struct totals {
+				std::size_t refills = 0, refilled = 0, refill_capacity = 0, steal_tries = 0, steals = 0, spins = 0, spin_hits = 0;
+			};
+
+			template <typename Threads>
+			void Update(Threads& threads, std::size_t backlog, std::chrono::steady_clock::duration elapsed) {
+				totals now;
+				for (auto& t : threads) {
+					const adaptive_sample& s = t->sample();
+					now.refills         += s.refills.load(std::memory_order_relaxed);
+					now.refilled        += s.refilled.load(std::memory_order_relaxed);
+					now.refill_capacity += s.refill_capacity.load(std::memory_order_relaxed);
+					now.steal_tries     += s.steal_tries.load(std::memory_order_relaxed);
+					now.steals          += s.steals.load(std::memory_order_relaxed);
+					now.spins           += s.spins.load(std::memory_order_relaxed);
+					now.spin_hits       += s.spin_hits.load(std::memory_order_relaxed);
+				}
+				totals delta{
+					now.refills - last_.refills, now.refilled - last_.refilled, now.refill_capacity - last_.refill_capacity,
+					now.steal_tries - last_.steal_tries, now.steals - last_.steals, now.spins - last_.spins, now.spin_hits - last_.spin_hits };
+				last_ = now;
+
+				if (delta.spins) {
+					Adjust(spin_budget_, delta.spin_hits * 2 > delta.spins, delta.spin_hits * 10 < delta.spins, 1, max_spin_budget);
+				}
+				if (delta.refills) {
+					bool full   = delta.refilled * 4 >= delta.refill_capacity * 3;
+					bool stolen = delta.steals * 4 > delta.refills;
+					Adjust(batch_size_, full && !stolen, stolen, 1, max_batch_size);
+				}
+				if (delta.refilled && elapsed.count() > 0) {
+					// Little's law: the time to drain the current backlog at the observed rate
+					double rate  = double(delta.refilled) / std::chrono::duration<double>(elapsed).count();
+					auto   delay = std::chrono::duration<double>(double(backlog) / rate);
+					Adjust(grow_threshold_, delay < target_latency / 4, delay > target_latency, min_grow_threshold, max_grow_threshold);
+				}
+			}
+
+			static void Adjust(std::atomic_size_t& knob, bool up, bool down, std::size_t lower, std::size_t upper) noexcept {
+				std::size_t value = knob.load(std::memory_order_relaxed);
+				if (up) {
+					value = std::min(upper, value * 2);
+				}
+				else if (down) {
+					value = std::max(lower, value / 2);
+				}
+				knob.store(value, std::memory_order_relaxed);
+			}
+
+			std::atomic_size_t batch_size_     = max_batch_size;
+			std::atomic_size_t spin_budget_    = constant_traits::WORKSTEAL_PARK_SPIN_TIMES ? constant_traits::WORKSTEAL_PARK_SPIN_TIMES : 1;
+			std::atomic_size_t grow_threshold_ = initial_grow_threshold;
+
+			std::atomic<std::chrono::steady_clock::rep> next_update_ = 0;
+			std::atomic_bool                            updating_    = false;
+			std::chrono::steady_clock::rep              last_update_ = 0;
+			totals                                      last_;
+		};
+	}
+}
+
+#endif // !COFLUX_ADAPTIVE_CONTROLLER_HPP
\ No newline at end of file
@@ -0,0 +1,165 @@
+#if defined(_MSC_VER) && _MSC_VER > 1000 || defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 3)
+#pragma once
+#endif
+
+#ifndef COFLUX_BLOCKING_POOL_HPP
+#define COFLUX_BLOCKING_POOL_HPP
+
+#include "../detail/forward_declaration.hpp"
+#include <unordered_map>
+
+namespace coflux {
+	namespace concurrent {
+		class blocking_pool {
+		public:
+			/*
+			*			Threads for coroutines which are about to block (syscalls, legacy libraries).
+			*			A submit is taken by an idle thread if there is one, otherwise a new thread is started
+			*			until max_threads run, then it waits in the queue until queue_capacity is reached.
+			*			A thread which stays idle for idle_timeout exits, so the pool shrinks back to zero.
+			*/
+			using duration = std::chrono::milliseconds;
+
+			static constexpr std::size_t default_max_threads    = 512;
+			static constexpr std::size_t default_queue_capacity = 1024;
+			static constexpr duration    default_idle_timeout   = std::chrono::seconds(10);
+
+		public:
+			explicit blocking_pool(
+				std::size_t max_threads    = default_max_threads,
+				std::size_t queue_capacity = default_queue_capacity,
+				duration    idle_timeout   = default_idle_timeout)
+				: max_threads_(std::max<std::size_t>(1, max_threads))
+				, queue_capacity_(queue_capacity)
+				, idle_timeout_(idle_timeout) {}
+			~blocking_pool() {
+				shutdown();
+			}
+
+			blocking_pool(const blocking_pool&)            = delete;
+			blocking_pool(blocking_pool&&)                 = delete;
+			blocking_pool& operator=(const blocking_pool&) = delete;
+			blocking_pool& operator=(blocking_pool&&)      = delete;
+
+			// Handles that never ran are dropped, like edf_pool.
+			void shutdown() {
+				std::unordered_map<std::thread::id, std::thread> threads;
+				std::vector<std::thread>                         retired;
+				{
+					std::lock_guard<std::mutex> guard(mtx_);
+					if (!running_) {
+						return;
+					}
+					running_ = false;
+					threads.swap(threads_);
+					retired.swap(retired_);
+					queue_.clear();
+				}
+				cv_.notify_all();
+				for (auto& [id, t] : threads) {
+					t.join();
+				}
+				for (auto& t : retired) {
+					t.join();
+				}
+			}
+
+			void submit(std::coroutine_handle<> handle) {
+				std::vector<std::thread> retired;
+				{
+					std::lock_guard<std::mutex> guard(mtx_);
+					if (!running_) COFLUX_ATTRIBUTES(COFLUX_UNLIKELY) {
+						Submit_error();
+					}
+					bool spawn = idle_ <= queue_.size() && threads_.size() < max_threads_;
+					if (!spawn && idle_ <= queue_.size() && queue_.size() >= queue_capacity_) COFLUX_ATTRIBUTES(COFLUX_UNLIKELY) {
+						Full_error();
+					}
+					queue_.push_back(handle);
+					if (spawn) {
+						std::thread t(&blocking_pool::work, this);
+						threads_.emplace(t.get_id(), std::move(t));
+					}
+					retired.swap(retired_);
+				}
+				cv_.notify_one();
+				for (auto& t : retired) {
+					t.join();
+				}
+			}
+
+			// Threads alive right now, busy or idle.
+			std::size_t size() {
+				std::lock_guard<std::mutex> guard(mtx_);
+				return threads_.size();
+			}
+
+			std::size_t idle_size() {
+				std::lock_guard<std::mutex> guard(mtx_);
+				return idle_;
+			}
+
+			std::size_t queue_size() {
+				std::lock_guard<std::mutex> guard(mtx_);
+				return queue_.size();
+			}
+
+			std::size_t max_threads() const noexcept {
+				return max_threads_;
+			}
+
+		private:
+			void work() {
+				std::unique_lock<std::mutex> lock(mtx_);
+				while (true) {
+					if (queue_.empty() && running_) {
+						idle_++;
+						bool woken = cv_.wait_for(lock, idle_timeout_, [this]() { return !queue_.empty() || !running_; });
+						idle_--;
+						if (!woken) {
+							Retire();
+							return;
+						}
+					}
+					if (!running_) {
+						return;
+					}
+					std::coroutine_handle<> handle = queue_.front();
+					queue_.pop_front();
+					lock.unlock();
+					handle.resume();
+					lock.lock();
+				}
+			}
+
+			// A thread can't join itself, the next submit or shutdown joins it.
+			void Retire() {
+				auto it = threads_.find(std::this_thread::get_id());
+				retired_.push_back(std::move(it->second));
+				threads_.erase(it);
+			}
+
+			COFLUX_ATTRIBUTES(COFLUX_NORETURN) static void Submit_error() {
+				throw std::runtime_error("Blocking_pool can't take on a new task.");
+			}
+
+			COFLUX_ATTRIBUTES(COFLUX_NORETURN) static void Full_error() {
+				throw std::runtime_error("Blocking_pool queue is full.");
+			}
+
+		private:
+			std::size_t                                      max_threads_;
+			std::size_t                                      queue_capacity_;
+			duration                                         idle_timeout_;
+			bool                                             running_ = true;
+			std::size_t                                      idle_    = 0;
+			std::deque<std::coroutine_handle<>>              queue_;
+			std::unordered_map<std::thread::id, std::thread> threads_;
+			std::vector<std::thread>                         retired_;
+			std::condition_variable                          cv_;
+			std::mutex                                       mtx_;
+		};
+	}
+}
+
+#endif // !COFLUX_BLOCKING_POOL_HPP
\ No newline at end of file
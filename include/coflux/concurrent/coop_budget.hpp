@@ -0,0 +1,47 @@
+#if defined(_MSC_VER) && _MSC_VER > 1000 || defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 3)
+#pragma once
+#endif
+
+#ifndef COFLUX_COOP_BUDGET_HPP
+#define COFLUX_COOP_BUDGET_HPP
+
+#include "../detail/forward_declaration.hpp"
+
+namespace coflux {
+	namespace concurrent {
+		/*
+		*			How many awaits may complete without suspending during one resume of a worker.
+		*			The worker resets it before every resume, ready awaiters charge it, and once it runs out they
+		*			suspend anyway and re-queue the coroutine, so a coroutine whose awaits are always ready still
+		*			gives the rest of the worker's queue a turn.
+		*			Threads which never reset it (and COOPERATIVE_BUDGET = 0) are unlimited.
+		*/
+		struct coop_budget {
+			static constexpr std::size_t unlimited = std::size_t(-1);
+
+			static void reset(std::size_t budget) noexcept {
+				remaining_ = budget ? budget : unlimited;
+			}
+
+			// Charges one ready await, false once the budget of this resume is used up.
+			static bool consume() noexcept {
+				if (remaining_ == unlimited) COFLUX_ATTRIBUTES(COFLUX_LIKELY) {
+					return true;
+				}
+				if (remaining_ == 0) {
+					return false;
+				}
+				remaining_--;
+				return true;
+			}
+
+			static bool exhausted() noexcept {
+				return remaining_ == 0;
+			}
+
+			static inline thread_local std::size_t remaining_ = unlimited;
+		};
+	}
+}
+
+#endif // !COFLUX_COOP_BUDGET_HPP
\ No newline at end of file
@@ -0,0 +1,84 @@
+#if defined(_MSC_VER) && _MSC_VER > 1000 || defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 3)
+#pragma once
+#endif
+
+#ifndef COFLUX_DEADLINE_REGISTRY_HPP
+#define COFLUX_DEADLINE_REGISTRY_HPP
+
+#include "../detail/forward_declaration.hpp"
+#include <unordered_map>
+
+namespace coflux {
+	namespace concurrent {
+		class deadline_registry {
+		public:
+			/*
+			*			coroutine frame address -> deadline
+			*			Executors only see std::coroutine_handle<>, so the deadline of a task or fork is published here
+			*			by its promise and looked up by the frame address of the handle being executed.
+			*			Frames without a deadline are never inserted, lookups return `none` for them.
+			*/
+			using clock      = std::chrono::steady_clock;
+			using time_point = clock::time_point;
+
+			static constexpr time_point  none        = time_point::max();
+			static constexpr std::size_t shard_count = 16;
+
+		public:
+			deadline_registry()  = default;
+			~deadline_registry() = default;
+
+			deadline_registry(const deadline_registry&)            = delete;
+			deadline_registry(deadline_registry&&)                 = delete;
+			deadline_registry& operator=(const deadline_registry&) = delete;
+			deadline_registry& operator=(deadline_registry&&)      = delete;
+
+			static deadline_registry& instance() {
+				static deadline_registry registry;
+				return registry;
+			}
+
+			void set(void* frame, time_point deadline) {
+				shard& s = Shard_of(frame);
+				std::lock_guard<std::mutex> guard(s.mtx_);
+				if (s.deadlines_.insert_or_assign(frame, deadline).second) {
+					size_.fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+
+			void erase(void* frame) {
+				shard& s = Shard_of(frame);
+				std::lock_guard<std::mutex> guard(s.mtx_);
+				if (s.deadlines_.erase(frame)) {
+					size_.fetch_sub(1, std::memory_order_relaxed);
+				}
+			}
+
+			time_point get(void* frame) {
+				if (size_.load(std::memory_order_relaxed) == 0) COFLUX_ATTRIBUTES(COFLUX_LIKELY) {
+					return none;
+				}
+				shard& s = Shard_of(frame);
+				std::lock_guard<std::mutex> guard(s.mtx_);
+				auto iter = s.deadlines_.find(frame);
+				return iter == s.deadlines_.end() ? none : iter->second;
+			}
+
+		private:
+			struct alignas(64) shard {
+				std::mutex                              mtx_;
+				std::unordered_map<void*, time_point>   deadlines_;
+			};
+
+			// frames are at least 16-byte aligned, the low bits carry no information
+			shard& Shard_of(void* frame) noexcept {
+				return shards_[(reinterpret_cast<std::uintptr_t>(frame) >> 4) % shard_count];
+			}
+
+			std::array<shard, shard_count> shards_;
+			std::atomic_size_t             size_ = 0;
+		};
+	}
+}
+
+#endif // !COFLUX_DEADLINE_REGISTRY_HPP
\ No newline at end of file
@@ -0,0 +1,157 @@
+#if defined(_MSC_VER) && _MSC_VER > 1000 || defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 3)
+#pragma once
+#endif
+
+#ifndef COFLUX_EDF_POOL_HPP
+#define COFLUX_EDF_POOL_HPP
+
+#include "../detail/forward_declaration.hpp"
+#include "deadline_registry.hpp"
+
+namespace coflux {
+	namespace concurrent {
+		class edf_pool {
+		public:
+			/*
+			*			One run queue ordered by deadline (earliest first), ties and handles without a deadline in
+			*			submission order. Handles without a deadline run after every handle that has one.
+			*			Deadlines come from deadline_registry unless they are given to submit.
+			*/
+			using clock      = deadline_registry::clock;
+			using time_point = deadline_registry::time_point;
+
+			struct entry {
+				time_point              deadline;
+				std::size_t             seq;
+				std::coroutine_handle<> handle;
+			};
+
+			struct entry_greater {
+				bool operator()(const entry& a, const entry& b) const noexcept {
+					if (a.deadline != b.deadline) {
+						return a.deadline > b.deadline;
+					}
+					return a.seq > b.seq;
+				}
+			};
+
+			using queue_type = std::priority_queue<entry, std::vector<entry>, entry_greater>;
+
+		public:
+			explicit edf_pool(std::size_t thread_size = std::thread::hardware_concurrency())
+				: thread_size_(std::max<std::size_t>(1, thread_size)) {
+				run();
+			}
+			~edf_pool() {
+				shutdown();
+			}
+
+			edf_pool(const edf_pool&)            = delete;
+			edf_pool(edf_pool&&)                 = delete;
+			edf_pool& operator=(const edf_pool&) = delete;
+			edf_pool& operator=(edf_pool&&)      = delete;
+
+			void run() {
+				std::lock_guard<std::mutex> guard(mtx_);
+				if (running_) {
+					return;
+				}
+				running_ = true;
+				for (std::size_t i = 0; i < thread_size_; i++) {
+					threads_.emplace_back(&edf_pool::work, this);
+				}
+			}
+
+			// Handles that never ran are dropped, like worker_thread.
+			void shutdown() {
+				{
+					std::lock_guard<std::mutex> guard(mtx_);
+					if (!running_) {
+						return;
+					}
+					running_ = false;
+				}
+				cv_.notify_all();
+				for (auto& t : threads_) {
+					t.join();
+				}
+				threads_.clear();
+				queue_ = queue_type();
+			}
+
+			void submit(std::coroutine_handle<> handle) {
+				submit(handle, deadline_registry::instance().get(handle.address()));
+			}
+
+			void submit(std::coroutine_handle<> handle, time_point deadline) {
+				{
+					std::lock_guard<std::mutex> guard(mtx_);
+					if (!running_) COFLUX_ATTRIBUTES(COFLUX_UNLIKELY) {
+						Submit_error();
+					}
+					queue_.push(entry{ deadline, seq_++, handle });
+				}
+				cv_.notify_one();
+			}
+
+			// Deadlines are looked up before the lock is taken, then the batch goes in under one lock.
+			void submit_bulk(std::span<const std::coroutine_handle<>> handles) {
+				std::vector<time_point> deadlines;
+				deadlines.reserve(handles.size());
+				for (auto handle : handles) {
+					deadlines.push_back(deadline_registry::instance().get(handle.address()));
+				}
+				{
+					std::lock_guard<std::mutex> guard(mtx_);
+					if (!running_) COFLUX_ATTRIBUTES(COFLUX_UNLIKELY) {
+						Submit_error();
+					}
+					for (std::size_t i = 0; i < handles.size(); i++) {
+						queue_.push(entry{ deadlines[i], seq_++, handles[i] });
+					}
+				}
+				if (handles.size() > 1) {
+					cv_.notify_all();
+				}
+				else {
+					cv_.notify_one();
+				}
+			}
+
+			std::size_t size() const noexcept {
+				return thread_size_;
+			}
+
+		private:
+			void work() {
+				std::unique_lock<std::mutex> lock(mtx_);
+				while (true) {
+					cv_.wait(lock, [this]() { return !queue_.empty() || !running_; });
+					if (!running_) {
+						return;
+					}
+					std::coroutine_handle<> handle = queue_.top().handle;
+					queue_.pop();
+					lock.unlock();
+					handle.resume();
+					lock.lock();
+				}
+			}
+
+			COFLUX_ATTRIBUTES(COFLUX_NORETURN) static void Submit_error() {
+				throw std::runtime_error("Edf_pool can't take on a new task.");
+			}
+
+		private:
+			std::size_t              thread_size_;
+			bool                     running_ = false;
+			std::size_t              seq_     = 0;
+			queue_type               queue_;
+			std::vector<std::thread> threads_;
+			std::condition_variable  cv_;
+			std::mutex               mtx_;
+		};
+	}
+}
+
+#endif // !COFLUX_EDF_POOL_HPP
\ No newline at end of file
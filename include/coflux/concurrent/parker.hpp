@@ -0,0 +1,87 @@
+#if defined(_MSC_VER) && _MSC_VER > 1000 || defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 3)
+#pragma once
+#endif
+
+#ifndef COFLUX_PARKER_HPP
+#define COFLUX_PARKER_HPP
+
+#include "../detail/forward_declaration.hpp"
+
+namespace coflux {
+	namespace concurrent {
+		class parker {
+		public:
+			/*
+			*			empty --prepare_park--> parked --unpark--> notified --park--> empty
+			*			  ^                       |
+			*			  +-------unpark----------+ (cancel_park / timeout)
+			*
+			*			A worker announces itself with prepare_park, looks for work one last time, then parks.
+			*			unpark is sticky: if it lands between prepare_park and park, park returns immediately.
+			*			The sleep itself is a binary_semaphore, which is futex-backed like std::atomic::wait
+			*			but also has a timed form.
+			*/
+			enum state : int {
+				empty, parked, notified
+			};
+
+		public:
+			parker()  = default;
+			~parker() = default;
+
+			parker(const parker&)            = delete;
+			parker(parker&&)                 = delete;
+			parker& operator=(const parker&) = delete;
+			parker& operator=(parker&&)      = delete;
+
+			void prepare_park() noexcept {
+				state_.store(parked, std::memory_order_seq_cst);
+			}
+
+			// We found work after prepare_park, returns true if an unpark raced in (and was consumed).
+			bool cancel_park() noexcept {
+				if (state_.exchange(empty, std::memory_order_acq_rel) == notified) {
+					sem_.acquire();
+					return true;
+				}
+				return false;
+			}
+
+			void park() noexcept {
+				sem_.acquire();
+				state_.store(empty, std::memory_order_relaxed);
+			}
+
+			// Returns false if nobody unparked us within `timeout`.
+			template <typename Rep, typename Period>
+			bool park_for(const std::chrono::duration<Rep, Period>& timeout) {
+				if (sem_.try_acquire_for(timeout)) {
+					state_.store(empty, std::memory_order_relaxed);
+					return true;
+				}
+				// The unparker saw `parked` and is about to release, take its token so the next park doesn't fall through.
+				return cancel_park();
+			}
+
+			// Wakes the owner only if it is parked (or about to park), returns false otherwise.
+			bool try_unpark() noexcept {
+				int expected = parked;
+				if (state_.compare_exchange_strong(expected, notified, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+					sem_.release();
+					return true;
+				}
+				return false;
+			}
+
+			bool is_parked() const noexcept {
+				return state_.load(std::memory_order_relaxed) == parked;
+			}
+
+		private:
+			std::atomic_int       state_ = empty;
+			std::binary_semaphore sem_{ 0 };
+		};
+	}
+}
+
+#endif // !COFLUX_PARKER_HPP
\ No newline at end of file
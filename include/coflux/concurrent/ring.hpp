@@ -217,7 +217,8 @@ namespace coflux {
 				size_type t = tail_.fetch_sub(1, std::memory_order_relaxed) - 1;
 				std::atomic_thread_fence(std::memory_order_seq_cst);
 				size_type h = head_.load(std::memory_order_relaxed);
-				if (h <= t) {
+				// signed compare, the tail of an untouched ring underflows here
+				if (std::int64_t(h) <= std::int64_t(t)) {
 					if (h == t) {
 						if (!head_.compare_exchange_strong(h, h + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
 							tail_.store(t + 1, std::memory_order_relaxed);
@@ -237,7 +238,7 @@ namespace coflux {
 				size_type h = head_.load(std::memory_order_acquire);
 				std::atomic_thread_fence(std::memory_order_seq_cst);
 				size_type t = tail_.load(std::memory_order_acquire);
-				if (h < t) {
+				if (std::int64_t(h) < std::int64_t(t)) {
 					value_type res = buffer_[h & mask]; // This will be midundersrtood by TSAN
 					if (!head_.compare_exchange_strong(h, h + 1,
 						std::memory_order_seq_cst, std::memory_order_relaxed)) {
@@ -306,6 +307,266 @@ namespace coflux {
 			alignas(align) std::atomic_size_t tail_ = 0;
 		};
 
+		template <typename Ty, std::size_t N, std::size_t Align>
+		class ChaseLev_deque {
+		public:
+			/*
+			*			SPMC <- head(front)-------------tail(back) <-> SPSC
+			*			Same protocol as ChaseLev_ring, but the owner doubles the buffer instead of failing when it is full.
+			*			Thieves announce themselves in stealers_, so the owner frees old buffers only when nobody can be reading them.
+			*/
+			static_assert(std::is_assignable_v<Ty, std::nullptr_t>, "ChaseLev_deque only support the type which is assignable from nullptr.");
+			static_assert(std::is_default_constructible_v<Ty>,      "ChaseLev_deque only support the type which is default_constructible.");
+			static_assert(std::is_move_constructible_v<Ty>,         "ChaseLev_deque only support the type which is move_constructible.");
+
+			static_assert(  N,			 "N shoud be larger than zero");
+			static_assert(!(N& (N - 1)), "N should be power of 2.");
+
+			using value_type      = Ty;
+			using size_type       = std::size_t;
+			using reference       = value_type&;
+			using const_reference = const value_type&;
+
+			using iterator = ring_iterator<ChaseLev_deque>;
+
+			static constexpr size_type initial_capacity = N;
+			static constexpr size_type align            = Align;
+
+		private:
+			struct buffer {
+				explicit buffer(size_type capacity)
+					: capacity_(capacity), mask_(capacity - 1), data_(std::make_unique<value_type[]>(capacity)) {}
+
+				value_type& operator[](size_type pos) noexcept {
+					return data_[pos & mask_];
+				}
+
+				size_type					  capacity_;
+				size_type					  mask_;
+				std::unique_ptr<value_type[]> data_;
+				buffer*						  retired_next_ = nullptr;
+			};
+
+		public:
+			ChaseLev_deque() : buffer_(new buffer(initial_capacity)) {}
+			~ChaseLev_deque() {
+				Reclaim();
+				delete buffer_.load(std::memory_order_relaxed);
+			}
+
+			ChaseLev_deque(const ChaseLev_deque&)			 = delete;
+			ChaseLev_deque(ChaseLev_deque&&)				 = delete;
+			ChaseLev_deque& operator=(const ChaseLev_deque&) = delete;
+			ChaseLev_deque& operator=(ChaseLev_deque&&)      = delete;
+
+			COFLUX_ATTRIBUTES(COFLUX_NO_TSAN) value_type try_pop_back() noexcept {
+				buffer*   buf = buffer_.load(std::memory_order_relaxed);
+				size_type t   = tail_.fetch_sub(1, std::memory_order_relaxed) - 1;
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				size_type h = head_.load(std::memory_order_relaxed);
+				if (std::int64_t(h) <= std::int64_t(t)) {
+					value_type res = (*buf)[t];
+					if (h == t) {
+						if (!head_.compare_exchange_strong(h, h + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+							tail_.store(t + 1, std::memory_order_relaxed);
+							return nullptr;
+						}
+						tail_.store(t + 1, std::memory_order_relaxed);
+					}
+					return res;
+				}
+				else {
+					tail_.store(t + 1, std::memory_order_relaxed);
+					return nullptr;
+				}
+			}
+
+			COFLUX_ATTRIBUTES(COFLUX_NO_TSAN) value_type try_pop_front() noexcept {
+				stealers_.fetch_add(1, std::memory_order_seq_cst);
+				size_type h = head_.load(std::memory_order_acquire);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				size_type t = tail_.load(std::memory_order_acquire);
+				value_type res = nullptr;
+				if (std::int64_t(h) < std::int64_t(t)) {
+					res = (*buffer_.load(std::memory_order_seq_cst))[h];
+					if (!head_.compare_exchange_strong(h, h + 1,
+						std::memory_order_seq_cst, std::memory_order_relaxed)) {
+						res = nullptr;
+					}
+				}
+				stealers_.fetch_sub(1, std::memory_order_release);
+				return res;
+			}
+
+			template <typename...Args>
+			bool try_push_back(Args&&...args) /* Only fails if the allocation throws */ {
+				size_type t   = tail_.load(std::memory_order_relaxed);
+				size_type h   = head_.load(std::memory_order_acquire);
+				buffer*   buf = buffer_.load(std::memory_order_relaxed);
+				if (buf->capacity_ <= t - h) {
+					buf = Grow(buf, h, t, buf->capacity_ * 2);
+				}
+				else if (retired_) COFLUX_ATTRIBUTES(COFLUX_UNLIKELY) {
+					Try_reclaim();
+				}
+				(*buf)[t] = value_type(std::forward<Args>(args)...);
+				std::atomic_thread_fence(std::memory_order_release);
+				tail_.store(t + 1, std::memory_order_relaxed);
+				return true;
+			}
+
+			// Makes room for at least `count` more elements behind the tail, used before writing through end().
+			void reserve_back(size_type count) {
+				size_type t   = tail_.load(std::memory_order_relaxed);
+				size_type h   = head_.load(std::memory_order_acquire);
+				buffer*   buf = buffer_.load(std::memory_order_relaxed);
+				if (buf->capacity_ < t - h + count) {
+					Grow(buf, h, t, size_upper(t - h + count));
+				}
+			}
+
+			auto begin() const noexcept /* Unsync */ {
+				buffer* buf = buffer_.load(std::memory_order_relaxed);
+				return iterator(head_.load(std::memory_order_relaxed), 0, buf->data_.get(), buf->capacity_);
+			}
+
+			auto end() const noexcept /* Unsync */ {
+				buffer* buf = buffer_.load(std::memory_order_relaxed);
+				return iterator(tail_.load(std::memory_order_relaxed), 0, buf->data_.get(), buf->capacity_);
+			}
+
+			bool empty() const noexcept {
+				return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+			}
+
+			size_type size_approx() const noexcept {
+				return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+			}
+
+			size_type capacity() const noexcept {
+				return buffer_.load(std::memory_order_relaxed)->capacity_;
+			}
+
+			std::atomic_size_t& head() noexcept {
+				return head_;
+			}
+
+			std::atomic_size_t& tail() noexcept {
+				return tail_;
+			}
+
+		private:
+			buffer* Grow(buffer* old, size_type h, size_type t, size_type capacity) {
+				buffer* buf = new buffer(capacity);
+				for (size_type i = h; i != t; i++) {
+					(*buf)[i] = (*old)[i];
+				}
+				buffer_.store(buf, std::memory_order_seq_cst);
+				old->retired_next_ = retired_;
+				retired_           = old;
+				Try_reclaim();
+				return buf;
+			}
+
+			void Try_reclaim() noexcept {
+				if (stealers_.load(std::memory_order_seq_cst) == 0) {
+					Reclaim();
+				}
+			}
+
+			void Reclaim() noexcept {
+				while (retired_) {
+					delete std::exchange(retired_, retired_->retired_next_);
+				}
+			}
+
+			alignas(align) std::atomic_size_t   head_     = 0;
+			alignas(align) std::atomic<buffer*> buffer_;
+			alignas(align) std::atomic_size_t   tail_     = 0;
+			alignas(align) std::atomic_size_t   stealers_ = 0;
+			buffer*								retired_  = nullptr;
+		};
+
+		template <typename Ty, std::size_t N, std::size_t Align>
+		class SPSC_ring {
+		public:
+			/*
+			*			producer -> tail(back)-------------head(front) -> consumer
+			*			Each side keeps a stale copy of the other side's index and only reloads it
+			*			when the ring looks full (producer) or empty (consumer).
+			*/
+			static_assert(std::is_default_constructible_v<Ty>, "SPSC_ring only support the type which is default_constructible.");
+			static_assert(std::is_move_assignable_v<Ty>,       "SPSC_ring only support the type which is move_assignable.");
+
+			static_assert( N,			  "N shoud be larger than zero");
+			static_assert(!(N & (N - 1)), "N should be power of 2.");
+
+			using buffer = std::array<Ty, N>;
+
+			using value_type      = Ty;
+			using size_type       = std::size_t;
+			using reference       = value_type&;
+			using const_reference = const value_type&;
+
+			static constexpr size_type mask  = N - 1;
+			static constexpr size_type align = Align;
+
+		public:
+			SPSC_ring()  = default;
+			~SPSC_ring() = default;
+
+			SPSC_ring(const SPSC_ring&)            = delete;
+			SPSC_ring(SPSC_ring&&)                 = delete;
+			SPSC_ring& operator=(const SPSC_ring&) = delete;
+			SPSC_ring& operator=(SPSC_ring&&)      = delete;
+
+			template <typename...Args>
+			bool try_push_back(Args&&...args) /* Only called by the producer */ {
+				size_type tail = tail_.load(std::memory_order_relaxed);
+				if (tail - head_cache_ == N) {
+					head_cache_ = head_.load(std::memory_order_acquire);
+					if (tail - head_cache_ == N) {
+						return false;
+					}
+				}
+				buffer_[tail & mask] = value_type(std::forward<Args>(args)...);
+				tail_.store(tail + 1, std::memory_order_release);
+				return true;
+			}
+
+			std::optional<value_type> try_pop_front() /* Only called by the consumer */ {
+				size_type head = head_.load(std::memory_order_relaxed);
+				if (head == tail_cache_) {
+					tail_cache_ = tail_.load(std::memory_order_acquire);
+					if (head == tail_cache_) {
+						return std::nullopt;
+					}
+				}
+				value_type res = std::move(buffer_[head & mask]);
+				head_.store(head + 1, std::memory_order_release);
+				return res;
+			}
+
+			bool empty() const noexcept {
+				return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_relaxed);
+			}
+
+			size_type size_approx() const noexcept {
+				return tail_.load(std::memory_order_relaxed) - head_.load(std::memory_order_relaxed);
+			}
+
+			constexpr size_type capacity() const noexcept {
+				return N;
+			}
+
+		private:
+			alignas(align) buffer			   buffer_{};
+			alignas(align) std::atomic_size_t  head_       = 0;
+			size_type                          tail_cache_ = 0;
+			alignas(align) std::atomic_size_t  tail_       = 0;
+			size_type                          head_cache_ = 0;
+		};
+
 		template <typename Ty, std::size_t N, std::size_t Align>
 		class MPMC_ring {
 		public:
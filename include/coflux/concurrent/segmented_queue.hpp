@@ -0,0 +1,358 @@
+#if defined(_MSC_VER) && _MSC_VER > 1000 || defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 3)
+#pragma once
+#endif
+
+#ifndef COFLUX_SEGMENTED_QUEUE_HPP
+#define COFLUX_SEGMENTED_QUEUE_HPP
+
+#include "../detail/forward_declaration.hpp"
+
+namespace coflux {
+	namespace concurrent {
+		struct default_segmented_queue_constants {
+			static constexpr std::size_t SEGMENT_SIZE = 256;
+			// Slots per segment, a segment is written once from front to back and then retired.
+
+			static constexpr std::size_t ALIGN_OF_HEAD_TAIL = 64;
+		};
+
+		template <typename Constants>
+		struct segmented_queue_constant_traits {
+			static constexpr std::size_t SEGMENT_SIZE = []() consteval -> std::size_t {
+				if constexpr (requires{ Constants::SEGMENT_SIZE; }) {
+					return Constants::SEGMENT_SIZE;
+				}
+				else {
+					return default_segmented_queue_constants::SEGMENT_SIZE;
+				}
+			}();
+
+			static constexpr std::size_t ALIGN_OF_HEAD_TAIL = []() consteval -> std::size_t {
+				if constexpr (requires{ Constants::ALIGN_OF_HEAD_TAIL; }) {
+					return Constants::ALIGN_OF_HEAD_TAIL;
+				}
+				else {
+					return default_segmented_queue_constants::ALIGN_OF_HEAD_TAIL;
+				}
+			}();
+		};
+
+		template <typename Constants = default_segmented_queue_constants>
+		class segmented_queue {
+		public:
+			/*
+			*			head_ -> [ taken | taken | item | item ] -> [ item | item | ---- | ---- ] <- tail_
+			*			Producers claim a slot with fetch_add on the tail segment's enqueue index, consumers
+			*			claim one with fetch_add on the head segment's dequeue index and swap a `taken` mark in.
+			*			A consumer that gets ahead of a slow producer marks the slot too, the producer then retries
+			*			with a fresh index. Full segments are linked by the producer who first overflows them,
+			*			exhausted ones are unlinked by consumers and freed by epoch based reclamation.
+			*			The mutex and condition_variable are only touched when someone sleeps in wait_dequeue*.
+			*/
+			using constant_traits = segmented_queue_constant_traits<Constants>;
+
+			using value_type      = std::coroutine_handle<>;
+			using size_type       = std::size_t;
+			using reference       = value_type&;
+			using const_reference = const value_type&;
+
+			static constexpr size_type segment_size = constant_traits::SEGMENT_SIZE;
+			static constexpr size_type align        = constant_traits::ALIGN_OF_HEAD_TAIL;
+
+			static_assert(segment_size > 1, "SEGMENT_SIZE should be larger than one.");
+
+		private:
+			struct segment {
+				segment() = default;
+				explicit segment(void* first) : enqueue_index_(1) {
+					slots_[0].store(first, std::memory_order_relaxed);
+				}
+
+				alignas(align) std::atomic_size_t    enqueue_index_ = 0;
+				alignas(align) std::atomic_size_t    dequeue_index_ = 0;
+				alignas(align) std::atomic<segment*> next_          = nullptr;
+				std::array<std::atomic<void*>, segment_size> slots_{};
+				segment* retired_next_ = nullptr;
+			};
+
+			// RAII critical section of the reclamation scheme.
+			class guard {
+			public:
+				explicit guard(segmented_queue& queue) noexcept : queue_(queue) {
+					while (true) {
+						epoch_ = queue_.epoch_.load(std::memory_order_seq_cst);
+						queue_.readers_[epoch_ & 1].fetch_add(1, std::memory_order_seq_cst);
+						if (queue_.epoch_.load(std::memory_order_seq_cst) == epoch_) COFLUX_ATTRIBUTES(COFLUX_LIKELY) {
+							return;
+						}
+						queue_.readers_[epoch_ & 1].fetch_sub(1, std::memory_order_release);
+					}
+				}
+				~guard() {
+					queue_.readers_[epoch_ & 1].fetch_sub(1, std::memory_order_release);
+				}
+
+				guard(const guard&)            = delete;
+				guard& operator=(const guard&) = delete;
+
+			private:
+				segmented_queue& queue_;
+				size_type        epoch_ = 0;
+			};
+
+		public:
+			segmented_queue() {
+				segment* first = new segment();
+				head_.store(first, std::memory_order_relaxed);
+				tail_.store(first, std::memory_order_relaxed);
+			}
+			~segmented_queue() {
+				segment* seg = head_.load(std::memory_order_relaxed);
+				while (seg) {
+					segment* next = seg->next_.load(std::memory_order_relaxed);
+					delete seg;
+					seg = next;
+				}
+				for (auto& list : retired_) {
+					Free(list);
+				}
+			}
+
+			segmented_queue(const segmented_queue&)            = delete;
+			segmented_queue(segmented_queue&&)                 = delete;
+			segmented_queue& operator=(const segmented_queue&) = delete;
+			segmented_queue& operator=(segmented_queue&&)      = delete;
+
+			bool empty() noexcept {
+				return size_.load(std::memory_order_acquire) == 0;
+			}
+
+			size_type size_approx() noexcept {
+				return size_.load(std::memory_order_acquire);
+			}
+
+			void push(value_type value) {
+				enqueue(value);
+			}
+
+			void enqueue(value_type value) {
+				// counted before it is visible, so size_ never drops below the real size
+				size_.fetch_add(1, std::memory_order_seq_cst);
+				{
+					guard g(*this);
+					Enqueue(value.address());
+				}
+				Notify();
+			}
+
+			template <typename ForwardIt>
+			void enqueue_bulk(ForwardIt first, std::size_t count) {
+				if (count == 0) {
+					return;
+				}
+				size_.fetch_add(count, std::memory_order_seq_cst);
+				{
+					guard g(*this);
+					for (std::size_t i = 0; i < count; i++) {
+						Enqueue((*first++).address());
+					}
+				}
+				Notify();
+			}
+
+			value_type try_dequeue() {
+				value_type element = nullptr;
+				try_dequeue_bulk(&element, 1);
+				return element;
+			}
+
+			template <typename ForwardIt>
+			size_type try_dequeue_bulk(ForwardIt buffer, std::size_t capacity) {
+				if (capacity == 0 || size_.load(std::memory_order_acquire) == 0) {
+					return 0;
+				}
+				size_type counter = 0;
+				{
+					guard g(*this);
+					for (; counter < capacity; counter++) {
+						void* element = Dequeue();
+						if (!element) {
+							break;
+						}
+						*buffer++ = value_type::from_address(element);
+					}
+				}
+				if (counter) {
+					size_.fetch_sub(counter, std::memory_order_release);
+				}
+				return counter;
+			}
+
+			value_type wait_dequeue() {
+				value_type element = nullptr;
+				wait_dequeue_bulk(&element, 1);
+				return element;
+			}
+
+			template <typename Rep, typename Period>
+			value_type wait_dequeue_timed(const std::chrono::duration<Rep, Period>& wait_time) {
+				value_type element = nullptr;
+				wait_dequeue_bulk_timed(&element, 1, wait_time);
+				return element;
+			}
+
+			template <typename ForwardIt>
+			size_type wait_dequeue_bulk(ForwardIt buffer, std::size_t capacity) {
+				while (true) {
+					if (size_type n = try_dequeue_bulk(buffer, capacity)) {
+						return n;
+					}
+					Sleep([this]() { return size_.load(std::memory_order_seq_cst) > 0; },
+						[this](auto& lock, auto&& pred) { not_empty_cv_.wait(lock, pred); return true; });
+				}
+			}
+
+			template <typename ForwardIt, typename Rep, typename Period>
+			size_type wait_dequeue_bulk_timed(ForwardIt buffer, std::size_t capacity,
+				const std::chrono::duration<Rep, Period>& wait_time
+			) {
+				auto deadline = std::chrono::steady_clock::now() + wait_time;
+				while (true) {
+					if (size_type n = try_dequeue_bulk(buffer, capacity)) {
+						return n;
+					}
+					bool woken = Sleep([this]() { return size_.load(std::memory_order_seq_cst) > 0; },
+						[this, deadline](auto& lock, auto&& pred) { return not_empty_cv_.wait_until(lock, deadline, pred); });
+					if (!woken) {
+						return try_dequeue_bulk(buffer, capacity);
+					}
+				}
+			}
+
+			std::condition_variable& not_empty_cv() {
+				return not_empty_cv_;
+			}
+
+		private:
+			void Enqueue(void* element) {
+				while (true) {
+					segment*  seg   = tail_.load(std::memory_order_acquire);
+					size_type index = seg->enqueue_index_.fetch_add(1, std::memory_order_acq_rel);
+					if (index < segment_size) COFLUX_ATTRIBUTES(COFLUX_LIKELY) {
+						void* expected = nullptr;
+						if (seg->slots_[index].compare_exchange_strong(expected, element, std::memory_order_release, std::memory_order_relaxed)) {
+							return;
+						}
+						// a consumer overtook us and marked the slot, try again
+						continue;
+					}
+					if (seg != tail_.load(std::memory_order_acquire)) {
+						continue;
+					}
+					segment* next = seg->next_.load(std::memory_order_acquire);
+					if (next == nullptr) {
+						segment* fresh = new segment(element);
+						if (seg->next_.compare_exchange_strong(next, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+							tail_.compare_exchange_strong(seg, fresh, std::memory_order_acq_rel, std::memory_order_relaxed);
+							return;
+						}
+						delete fresh;
+					}
+					tail_.compare_exchange_strong(seg, next, std::memory_order_acq_rel, std::memory_order_relaxed);
+				}
+			}
+
+			void* Dequeue() {
+				while (true) {
+					segment*  seg   = head_.load(std::memory_order_acquire);
+					size_type index = seg->dequeue_index_.load(std::memory_order_acquire);
+					if (index < segment_size && index >= seg->enqueue_index_.load(std::memory_order_acquire)) {
+						return nullptr;
+					}
+					if (index < segment_size) {
+						index = seg->dequeue_index_.fetch_add(1, std::memory_order_acq_rel);
+					}
+					if (index >= segment_size) {
+						segment* next = seg->next_.load(std::memory_order_acquire);
+						if (next == nullptr) {
+							return nullptr;
+						}
+						// tail_ must leave the segment before it is unlinked, nobody may reach it afterwards
+						segment* expected = seg;
+						tail_.compare_exchange_strong(expected, next, std::memory_order_acq_rel, std::memory_order_relaxed);
+						if (head_.compare_exchange_strong(seg, next, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+							Retire(seg);
+						}
+						continue;
+					}
+					void* element = seg->slots_[index].exchange(Taken(), std::memory_order_acq_rel);
+					if (element != nullptr) COFLUX_ATTRIBUTES(COFLUX_LIKELY) {
+						return element;
+					}
+					// the producer of this slot hasn't written yet, it will see our mark and retry
+				}
+			}
+
+			// Three lists and two reader counters: a segment retired in epoch e is freed when the epoch moves
+			// from e + 1 to e + 2, by then every reader who could still hold it has left.
+			void Retire(segment* seg) {
+				std::lock_guard<std::mutex> lock(retire_mtx_);
+				size_type epoch = epoch_.load(std::memory_order_seq_cst);
+				seg->retired_next_ = retired_[epoch % 3];
+				retired_[epoch % 3] = seg;
+				if (readers_[(epoch + 1) & 1].load(std::memory_order_seq_cst) == 0) {
+					epoch_.store(epoch + 1, std::memory_order_seq_cst);
+					Free(retired_[(epoch + 1) % 3]);
+				}
+			}
+
+			static void Free(segment*& list) noexcept {
+				while (list) {
+					segment* next = list->retired_next_;
+					delete list;
+					list = next;
+				}
+			}
+
+			static void* Taken() noexcept {
+				static char mark;
+				return &mark;
+			}
+
+			template <typename Pred, typename Wait>
+			bool Sleep(Pred&& pred, Wait&& wait) {
+				std::unique_lock<std::mutex> lock(mtx_);
+				sleepers_.fetch_add(1, std::memory_order_seq_cst);
+				bool res = wait(lock, pred);
+				sleepers_.fetch_sub(1, std::memory_order_relaxed);
+				return res;
+			}
+
+			// Pairs with Sleep: either the sleeper sees the new size, or we see the sleeper.
+			void Notify() {
+				if (sleepers_.load(std::memory_order_seq_cst)) COFLUX_ATTRIBUTES(COFLUX_UNLIKELY) {
+					{
+						std::lock_guard<std::mutex> lock(mtx_);
+					}
+					not_empty_cv_.notify_one();
+				}
+			}
+
+		private:
+			alignas(align) std::atomic<segment*> head_ = nullptr;
+			alignas(align) std::atomic<segment*> tail_ = nullptr;
+			alignas(align) std::atomic_size_t    size_ = 0;
+
+			alignas(align) std::atomic_size_t    epoch_ = 0;
+			std::array<std::atomic_size_t, 2>    readers_{};
+			std::array<segment*, 3>              retired_{};
+			std::mutex                           retire_mtx_;
+
+			alignas(align) std::atomic_size_t    sleepers_ = 0;
+			std::condition_variable              not_empty_cv_;
+			std::mutex                           mtx_;
+		};
+	}
+}
+
+#endif // !COFLUX_SEGMENTED_QUEUE_HPP
\ No newline at end of file
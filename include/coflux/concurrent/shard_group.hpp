@@ -0,0 +1,366 @@
+#if defined(_MSC_VER) && _MSC_VER > 1000 || defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 3)
+#pragma once
+#endif
+
+#ifndef COFLUX_SHARD_GROUP_HPP
+#define COFLUX_SHARD_GROUP_HPP
+
+#include "../detail/forward_declaration.hpp"
+#include "ring.hpp"
+#include "parker.hpp"
+#include "topology.hpp"
+#include "timer_node.hpp"
+
+namespace coflux {
+	namespace concurrent {
+		struct default_shard_group_constants {
+			static constexpr std::size_t SHARD_RING_CAPACITY = 256;
+			// Slots of the ring each shard keeps for every other shard, a full ring spills into the shard's locked inbox.
+
+			static constexpr bool        SHARD_PIN_THREADS   = true;
+			// true: shard i is pinned to the i-th cpu we may run on (wrapping around).
+
+			static constexpr std::size_t SHARD_RUN_BATCH     = 64;
+			// Handles a shard resumes from its run queue before it looks at its rings and timers again.
+		};
+
+		template <typename Constants>
+		struct shard_group_constant_traits {
+			static constexpr std::size_t SHARD_RING_CAPACITY = []() consteval -> std::size_t {
+				if constexpr (requires{ Constants::SHARD_RING_CAPACITY; }) {
+					return Constants::SHARD_RING_CAPACITY;
+				}
+				else {
+					return default_shard_group_constants::SHARD_RING_CAPACITY;
+				}
+			}();
+
+			static constexpr bool SHARD_PIN_THREADS = []() consteval -> bool {
+				if constexpr (requires{ Constants::SHARD_PIN_THREADS; }) {
+					return Constants::SHARD_PIN_THREADS;
+				}
+				else {
+					return default_shard_group_constants::SHARD_PIN_THREADS;
+				}
+			}();
+
+			static constexpr std::size_t SHARD_RUN_BATCH = []() consteval -> std::size_t {
+				if constexpr (requires{ Constants::SHARD_RUN_BATCH; }) {
+					return Constants::SHARD_RUN_BATCH;
+				}
+				else {
+					return default_shard_group_constants::SHARD_RUN_BATCH;
+				}
+			}();
+		};
+
+		template <std::size_t N, typename Constants = default_shard_group_constants>
+		class shard_group {
+		public:
+			/*
+			*			shard i: [ run queue | timers ]  <- ring(0 -> i) ... ring(N-1 -> i)  <- inbox (other threads, spills)
+			*			Every shard is one thread which owns its run queue and timer heaps outright, nobody else touches them,
+			*			other threads only hand cancelled sleeps back through the shard's cancel inbox.
+			*			A shard hands work to another shard through the ring dedicated to that (source, target) pair,
+			*			threads outside the group go through the target's locked inbox. An idle shard parks and
+			*			is unparked by whoever fills one of its rings or its inbox.
+			*/
+			using constant_traits = shard_group_constant_traits<Constants>;
+
+			using value_type = std::coroutine_handle<>;
+			using clock      = std::chrono::steady_clock;
+			using time_point = clock::time_point;
+
+			static constexpr std::size_t ring_capacity = constant_traits::SHARD_RING_CAPACITY;
+			static constexpr std::size_t run_batch     = constant_traits::SHARD_RUN_BATCH;
+
+			static_assert(N,         "N shoud be larger than zero");
+			static_assert(run_batch, "SHARD_RUN_BATCH should be larger than zero.");
+
+		private:
+			// `when` is the epoch for handles to run right away.
+			struct message {
+				value_type handle = nullptr;
+				time_point when{};
+			};
+
+			struct message_greater {
+				bool operator()(const message& a, const message& b) const noexcept {
+					return a.when > b.when;
+				}
+			};
+
+			using ring_type    = SPSC_ring<message, ring_capacity, 64>;
+			using message_heap = std::priority_queue<message, std::vector<message>, message_greater>;
+
+			struct shard {
+				// owned by the shard thread
+				unsync_ring<value_type> run_queue_;
+				message_heap            timers_;
+				timer_heap              sleeps_;
+
+				// cancelled sleeps, pushed by whoever cancels them
+				timer_cancel_inbox      sleep_cancels_;
+
+				// filled by the others
+				std::array<ring_type, N> rings_;
+				std::atomic_bool         has_inbox_ = false;
+				std::vector<message>     inbox_;
+				std::mutex               inbox_mtx_;
+
+				parker      parker_;
+				std::thread thread_;
+			};
+
+		public:
+			shard_group() {
+				run();
+			}
+			~shard_group() {
+				shutdown();
+			}
+
+			shard_group(const shard_group&)            = delete;
+			shard_group(shard_group&&)                 = delete;
+			shard_group& operator=(const shard_group&) = delete;
+			shard_group& operator=(shard_group&&)      = delete;
+
+			void run() {
+				if (running_.exchange(true)) {
+					return;
+				}
+				std::vector<int> cpus;
+				if constexpr (constant_traits::SHARD_PIN_THREADS) {
+					for (auto& info : topology::detect().cpus()) {
+						cpus.push_back(info.id);
+					}
+				}
+				for (std::size_t i = 0; i < N; i++) {
+					int cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+					shards_[i].thread_ = std::thread(&shard_group::work, this, i, cpu);
+				}
+			}
+
+			// Handles that never ran are dropped, like worker_thread.
+			void shutdown() {
+				if (!running_.exchange(false)) {
+					return;
+				}
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				for (auto& s : shards_) {
+					s.parker_.try_unpark();
+				}
+				for (auto& s : shards_) {
+					if (s.thread_.joinable()) {
+						s.thread_.join();
+					}
+				}
+				// Sleeps that never fired are dropped along with the handles: a cancelled one is only unlinked,
+				// the rest are handed back fired with fire == false, so that nobody tries to resume them.
+				for (auto& s : shards_) {
+					for (timer_node* node = s.sleep_cancels_.take(); node; node = node->cancel_next) {
+						if (node->index != timer_node::unlinked) {
+							s.sleeps_.erase(node);
+						}
+					}
+					while (!s.sleeps_.empty()) {
+						timer_node* node = s.sleeps_.pop();
+						if (node->try_fire()) {
+							node->invoke(node, false);
+						}
+					}
+				}
+			}
+
+			void submit(std::size_t target, value_type handle) {
+				Send(target, message{ handle, time_point{} });
+			}
+
+			// Runs `handle` on `target` once `delay` has passed, the timer lives on the target shard.
+			template <typename Rep, typename Period>
+			void submit_after(std::size_t target, value_type handle, const std::chrono::duration<Rep, Period>& delay) {
+				Send(target, message{ handle, clock::now() + std::chrono::duration_cast<clock::duration>(delay) });
+			}
+
+			// Only from shard `target` itself: the node goes into that shard's own timers and fires there.
+			// Returns false anywhere else, the caller falls back to a timer thread.
+			bool try_schedule_local(std::size_t target, timer_node* node, time_point deadline) {
+				if (target == N || current() != target) {
+					return false;
+				}
+				node->deadline = deadline;
+				node->timer    = &shards_[target];
+				node->revoke   = &shard_group::Revoke_sleep;
+				shards_[target].sleeps_.push(node);
+				return true;
+			}
+
+			// The shard the calling thread is, N if it isn't one of ours.
+			std::size_t current() const noexcept {
+				return current_group_ == this ? current_index_ : N;
+			}
+
+			// Round robin over the shards, for work that comes from outside the group.
+			std::size_t next_target() noexcept {
+				return next_.fetch_add(1, std::memory_order_relaxed) % N;
+			}
+
+		private:
+			void Send(std::size_t target, message msg) {
+				if (!running_.load(std::memory_order_acquire)) COFLUX_ATTRIBUTES(COFLUX_UNLIKELY) {
+					Submit_error();
+				}
+				shard& to = shards_[target];
+				std::size_t from = current();
+				if (from == target) {
+					// our own queues, no synchronization and nobody to wake up
+					Accept(to, msg);
+					return;
+				}
+				if (from == N || !to.rings_[from].try_push_back(msg)) {
+					std::lock_guard<std::mutex> guard(to.inbox_mtx_);
+					to.inbox_.push_back(msg);
+					to.has_inbox_.store(true, std::memory_order_relaxed);
+				}
+				// pairs with the fence between prepare_park and the last look at the rings
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				to.parker_.try_unpark();
+			}
+
+			static void Accept(shard& s, const message& msg) {
+				if (msg.when == time_point{}) {
+					s.run_queue_.push_back(msg.handle);
+				}
+				else {
+					s.timers_.push(msg);
+				}
+			}
+
+			void work(std::size_t index, int cpu) {
+				current_group_ = this;
+				current_index_ = index;
+				if (cpu >= 0) {
+					topology::pin_current_thread(cpu);
+				}
+				shard& self = shards_[index];
+				while (running_.load(std::memory_order_acquire)) {
+					Receive(self);
+					Fire_timers(self);
+					if (!self.run_queue_.empty()) {
+						for (std::size_t i = 0; i < run_batch && !self.run_queue_.empty(); i++) {
+							value_type handle = self.run_queue_.front();
+							self.run_queue_.pop_front();
+							handle.resume();
+						}
+						continue;
+					}
+
+					self.parker_.prepare_park();
+					std::atomic_thread_fence(std::memory_order_seq_cst);
+					if (Has_incoming(self) || !running_.load(std::memory_order_relaxed)) {
+						self.parker_.cancel_park();
+						continue;
+					}
+					if (self.timers_.empty() && self.sleeps_.empty()) {
+						self.parker_.park();
+					}
+					else {
+						self.parker_.park_for(Next_due(self) - clock::now());
+					}
+				}
+				current_group_ = nullptr;
+			}
+
+			void Receive(shard& self) {
+				for (auto& ring : self.rings_) {
+					while (auto msg = ring.try_pop_front()) {
+						Accept(self, *msg);
+					}
+				}
+				if (self.has_inbox_.load(std::memory_order_relaxed)) {
+					std::vector<message> inbox;
+					{
+						std::lock_guard<std::mutex> guard(self.inbox_mtx_);
+						inbox.swap(self.inbox_);
+						self.has_inbox_.store(false, std::memory_order_relaxed);
+					}
+					for (auto& msg : inbox) {
+						Accept(self, msg);
+					}
+				}
+			}
+
+			static void Fire_timers(shard& self) {
+				Handle_sleep_cancels(self);
+				if (self.timers_.empty() && self.sleeps_.empty()) {
+					return;
+				}
+				time_point now = clock::now();
+				while (!self.timers_.empty() && self.timers_.top().when <= now) {
+					self.run_queue_.push_back(self.timers_.top().handle);
+					self.timers_.pop();
+				}
+				// a sleeper that fires is resumed through its shard executor, which lands in our own run queue
+				while (!self.sleeps_.empty() && self.sleeps_.top()->deadline <= now) {
+					timer_node* node = self.sleeps_.pop();
+					// a cancelled node is already on its way back through sleep_cancels_
+					if (node->try_fire()) {
+						node->invoke(node, true);
+					}
+				}
+			}
+
+			static void Handle_sleep_cancels(shard& self) {
+				timer_node* node = self.sleep_cancels_.take();
+				while (node) {
+					timer_node* next = node->cancel_next;
+					if (node->index != timer_node::unlinked) {
+						self.sleeps_.erase(node);
+					}
+					node->invoke(node, false);
+					node = next;
+				}
+			}
+
+			// Any thread may cancel a sleep kept by a shard, the node is pushed back and the shard unlinks it itself.
+			static void Revoke_sleep(void* target, timer_node* node) noexcept {
+				auto* to = static_cast<shard*>(target);
+				to->sleep_cancels_.push(node);
+				to->parker_.try_unpark();
+			}
+
+			static time_point Next_due(const shard& self) noexcept {
+				if (self.timers_.empty()) {
+					return self.sleeps_.top()->deadline;
+				}
+				if (self.sleeps_.empty()) {
+					return self.timers_.top().when;
+				}
+				return std::min(self.timers_.top().when, self.sleeps_.top()->deadline);
+			}
+
+			static bool Has_incoming(shard& self) noexcept {
+				for (auto& ring : self.rings_) {
+					if (!ring.empty()) {
+						return true;
+					}
+				}
+				return self.has_inbox_.load(std::memory_order_relaxed) || !self.sleep_cancels_.empty()
+					|| ((!self.timers_.empty() || !self.sleeps_.empty()) && Next_due(self) <= clock::now());
+			}
+
+			COFLUX_ATTRIBUTES(COFLUX_NORETURN) static void Submit_error() {
+				throw std::runtime_error("Shard_group can't take on a new task.");
+			}
+
+			static inline thread_local const void* current_group_ = nullptr;
+			static inline thread_local std::size_t current_index_ = 0;
+
+			std::atomic_bool     running_ = false;
+			std::atomic_size_t   next_    = 0;
+			std::array<shard, N> shards_;
+		};
+	}
+}
+
+#endif // !COFLUX_SHARD_GROUP_HPP
\ No newline at end of file
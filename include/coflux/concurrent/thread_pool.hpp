@@ -11,16 +11,59 @@
 #include "../detail/forward_declaration.hpp"
 #include "ring.hpp"
 #include "unbounded_queue.hpp"
+#include "segmented_queue.hpp"
 #include "worksteal_thread.hpp"
+#include "adaptive_controller.hpp"
 
 namespace coflux {
 	namespace concurrent {
 		struct default_thread_pool_constants {
 			static constexpr std::size_t WORKSTEAL_LOCAL_QUEUE_CAPACITY       	  = 32;
 
+			static constexpr bool        WORKSTEAL_LOCAL_QUEUE_GROWABLE           = false;
+			// true: the local queue is a ChaseLev_deque which starts at WORKSTEAL_LOCAL_QUEUE_CAPACITY and doubles when full,
+			// instead of spilling to the global queue.
+
 			static constexpr std::size_t ALIGN_OF_LOCAL_QUEUE_HEAD_TAIL           = 64;
 
 			static constexpr std::size_t CACHED_MAX_IDLE_TIME_SECONDS             = 60;
+
+			static constexpr std::size_t WORKSTEAL_LIFO_SLOT_BUDGET               = 3;
+			// Consecutive resumes from the LIFO slot before the local deque gets a turn, 0 disables the slot.
+
+			static constexpr std::size_t WORKSTEAL_LIFO_SLOT_PRIVATE_TICKS        = 64;
+			// How many times thieves must find the LIFO slot occupied before they may take it.
+
+			static constexpr std::size_t WORKSTEAL_PARK_SPIN_TIMES                = 16;
+			// Rounds of (check global queue, try steal, yield) an idle worker spins before it parks.
+
+			static constexpr bool        WORKSTEAL_TOPOLOGY_AWARE                 = false;
+			// true: read the cpu topology (sysfs on linux), pin workers to cpus, keep one injection queue per NUMA node,
+			// and steal from SMT siblings, then the same llc, then the same node before remote workers.
+
+			static constexpr std::size_t PRIORITY_LEVELS                          = 1;
+			// Run levels of the pool, 0 is the highest. Workers drain higher levels first.
+
+			static constexpr std::size_t PRIORITY_AGING_INTERVAL                  = 8;
+			// Every PRIORITY_AGING_INTERVAL refills from the global queues, a lower level is served first.
+
+			static constexpr bool        ADAPTIVE_CONTROLLER                      = false;
+			// true: workers sample refills, steals and spins, and the pool retunes the spin budget, the refill batch size
+			// and the backlog that makes cached mode add a thread at runtime, see adaptive_controller.
+
+			static constexpr std::size_t ADAPTIVE_PERIOD_MICROSECONDS             = 10000;
+			// How often the adaptive controller folds the samples.
+
+			static constexpr std::size_t ADAPTIVE_TARGET_LATENCY_MICROSECONDS     = 1000;
+			// Queueing delay the adaptive controller tries to stay below in cached mode.
+
+			static constexpr bool        WORKSTEAL_STATISTICS                     = false;
+			// true: every worker keeps relaxed counters (resumes, global refills, steals, parks, idle time, local
+			// high-water mark) for thread_pool::stats(). false compiles them out, stats() then only reports `active`.
+
+			static constexpr std::size_t COOPERATIVE_BUDGET                       = 0;
+			// Awaits which may complete without suspending in one resume, after that ready awaiters (channel reads and
+			// writes, finished tasks) re-queue the coroutine anyway. 0 disables the budget, see coop_budget.
 		};
 
 		template <typename Constants>
@@ -34,6 +77,15 @@ namespace coflux {
 				}
 			}();
 
+			static constexpr bool WORKSTEAL_LOCAL_QUEUE_GROWABLE = []() consteval -> bool {
+				if constexpr (requires{ Constants::WORKSTEAL_LOCAL_QUEUE_GROWABLE; }) {
+					return Constants::WORKSTEAL_LOCAL_QUEUE_GROWABLE;
+				}
+				else {
+					return default_thread_pool_constants::WORKSTEAL_LOCAL_QUEUE_GROWABLE;
+				}
+			}();
+
 
 			static constexpr std::size_t ALIGN_OF_LOCAL_QUEUE_HEAD_TAIL = []() consteval -> std::size_t {
 				if constexpr (requires{ Constants::ALIGN_OF_LOCAL_QUEUE_HEAD_TAIL; }) {
@@ -52,6 +104,105 @@ namespace coflux {
 					return default_thread_pool_constants::CACHED_MAX_IDLE_TIME_SECONDS;
 				}
 			}();
+
+			static constexpr std::size_t WORKSTEAL_LIFO_SLOT_BUDGET = []() consteval -> std::size_t {
+				if constexpr (requires{ Constants::WORKSTEAL_LIFO_SLOT_BUDGET; }) {
+					return Constants::WORKSTEAL_LIFO_SLOT_BUDGET;
+				}
+				else {
+					return default_thread_pool_constants::WORKSTEAL_LIFO_SLOT_BUDGET;
+				}
+			}();
+
+			static constexpr std::size_t WORKSTEAL_LIFO_SLOT_PRIVATE_TICKS = []() consteval -> std::size_t {
+				if constexpr (requires{ Constants::WORKSTEAL_LIFO_SLOT_PRIVATE_TICKS; }) {
+					return Constants::WORKSTEAL_LIFO_SLOT_PRIVATE_TICKS;
+				}
+				else {
+					return default_thread_pool_constants::WORKSTEAL_LIFO_SLOT_PRIVATE_TICKS;
+				}
+			}();
+
+			static constexpr std::size_t WORKSTEAL_PARK_SPIN_TIMES = []() consteval -> std::size_t {
+				if constexpr (requires{ Constants::WORKSTEAL_PARK_SPIN_TIMES; }) {
+					return Constants::WORKSTEAL_PARK_SPIN_TIMES;
+				}
+				else {
+					return default_thread_pool_constants::WORKSTEAL_PARK_SPIN_TIMES;
+				}
+			}();
+
+			static constexpr bool WORKSTEAL_TOPOLOGY_AWARE = []() consteval -> bool {
+				if constexpr (requires{ Constants::WORKSTEAL_TOPOLOGY_AWARE; }) {
+					return Constants::WORKSTEAL_TOPOLOGY_AWARE;
+				}
+				else {
+					return default_thread_pool_constants::WORKSTEAL_TOPOLOGY_AWARE;
+				}
+			}();
+
+			static constexpr std::size_t PRIORITY_LEVELS = []() consteval -> std::size_t {
+				if constexpr (requires{ Constants::PRIORITY_LEVELS; }) {
+					return Constants::PRIORITY_LEVELS;
+				}
+				else {
+					return default_thread_pool_constants::PRIORITY_LEVELS;
+				}
+			}();
+
+			static constexpr std::size_t PRIORITY_AGING_INTERVAL = []() consteval -> std::size_t {
+				if constexpr (requires{ Constants::PRIORITY_AGING_INTERVAL; }) {
+					return Constants::PRIORITY_AGING_INTERVAL;
+				}
+				else {
+					return default_thread_pool_constants::PRIORITY_AGING_INTERVAL;
+				}
+			}();
+
+			static constexpr bool ADAPTIVE_CONTROLLER = []() consteval -> bool {
+				if constexpr (requires{ Constants::ADAPTIVE_CONTROLLER; }) {
+					return Constants::ADAPTIVE_CONTROLLER;
+				}
+				else {
+					return default_thread_pool_constants::ADAPTIVE_CONTROLLER;
+				}
+			}();
+
+			static constexpr std::size_t ADAPTIVE_PERIOD_MICROSECONDS = []() consteval -> std::size_t {
+				if constexpr (requires{ Constants::ADAPTIVE_PERIOD_MICROSECONDS; }) {
+					return Constants::ADAPTIVE_PERIOD_MICROSECONDS;
+				}
+				else {
+					return default_thread_pool_constants::ADAPTIVE_PERIOD_MICROSECONDS;
+				}
+			}();
+
+			static constexpr std::size_t ADAPTIVE_TARGET_LATENCY_MICROSECONDS = []() consteval -> std::size_t {
+				if constexpr (requires{ Constants::ADAPTIVE_TARGET_LATENCY_MICROSECONDS; }) {
+					return Constants::ADAPTIVE_TARGET_LATENCY_MICROSECONDS;
+				}
+				else {
+					return default_thread_pool_constants::ADAPTIVE_TARGET_LATENCY_MICROSECONDS;
+				}
+			}();
+
+			static constexpr bool WORKSTEAL_STATISTICS = []() consteval -> bool {
+				if constexpr (requires{ Constants::WORKSTEAL_STATISTICS; }) {
+					return Constants::WORKSTEAL_STATISTICS;
+				}
+				else {
+					return default_thread_pool_constants::WORKSTEAL_STATISTICS;
+				}
+			}();
+
+			static constexpr std::size_t COOPERATIVE_BUDGET = []() consteval -> std::size_t {
+				if constexpr (requires{ Constants::COOPERATIVE_BUDGET; }) {
+					return Constants::COOPERATIVE_BUDGET;
+				}
+				else {
+					return default_thread_pool_constants::COOPERATIVE_BUDGET;
+				}
+			}();
 		};
 
 		template <typename TaskQueue, typename Constants>
@@ -59,15 +210,17 @@ namespace coflux {
 		public:
 			using constant_traits = thread_pool_constant_traits<Constants>;
 
-			using thread_type    = worksteal_thread<
-				constant_traits::WORKSTEAL_LOCAL_QUEUE_CAPACITY, 
-				constant_traits::ALIGN_OF_LOCAL_QUEUE_HEAD_TAIL, 
-				constant_traits::CACHED_MAX_IDLE_TIME_SECONDS>;
-			using queue_type     = TaskQueue;
-			using value_type     = std::coroutine_handle<>;
+			using thread_type     = worksteal_thread<constant_traits>;
+			using queue_type      = TaskQueue;
+			using controller_type = adaptive_controller<constant_traits>;
+			using value_type      = std::coroutine_handle<>;
 
 			static_assert(std::same_as<value_type, std::coroutine_handle<>>, "value_type should be std::coroutine_handle<>.");
 
+			static constexpr std::size_t priority_levels = constant_traits::PRIORITY_LEVELS;
+
+			friend thread_type;
+
 		public:
 			template <typename...Args>
 			explicit thread_pool(
@@ -77,12 +230,25 @@ namespace coflux {
 				Args&&...        args																//arguments for task queue	
 			)	: basic_thread_size_(size_upper(basic_thread_size))
 				, mode_(run_mode)
-				, thread_size_threshold_(size_upper(thread_size_threshold)) 
-				, task_queue_(std::forward<Args>(args)...) {
+				, thread_size_threshold_(size_upper(thread_size_threshold)) {
+				// one injection queue per (level, node), level major
+				if constexpr (constant_traits::WORKSTEAL_TOPOLOGY_AWARE || priority_levels > 1) {
+					if constexpr (constant_traits::WORKSTEAL_TOPOLOGY_AWARE) {
+						topology_ = topology::detect();
+					}
+					for (std::size_t i = 0; i < priority_levels * topology_.node_size(); i++) {
+						task_queues_.emplace_back(std::make_unique<queue_type>(args...));
+					}
+				}
+				else {
+					task_queues_.emplace_back(std::make_unique<queue_type>(std::forward<Args>(args)...));
+				}
 				run();
 			}
+			// Aborts. Handles that never ran are neither resumed nor destroyed, so their frames leak:
+			// call shutdown() first to get them back, or shutdown(shutdown_mode::drain) to run them.
 			~thread_pool() {
-				shutdown();
+				static_cast<void>(shutdown());
 			};
 
 			thread_pool(const thread_pool&)			   = delete;
@@ -98,7 +264,6 @@ namespace coflux {
 				running_ = true;
 				for (int i = 0; i < basic_thread_size_; i++) {
 					thread_list_.emplace_back(std::make_unique<thread_type>());
-					thread_size_++;
 				}
 				if (mode_ == mode::cached) {
 					for (int i = int(basic_thread_size_); i < thread_size_threshold_; i++) {
@@ -106,36 +271,112 @@ namespace coflux {
 					}
 				}
 
+				if constexpr (constant_traits::WORKSTEAL_TOPOLOGY_AWARE) {
+					Place_threads();
+				}
+
 				for (int i = 0; i < basic_thread_size_; i++) {
-					thread_list_[i]->enable(task_queue_, mode_, running_, thread_size_, basic_thread_size_, thread_list_);
+					thread_list_[i]->enable(*this);
 				}
 			}
 
-			void shutdown() {
-				bool expected = true;
-				if (running_.compare_exchange_strong(expected, false, std::memory_order_acq_rel)) {
-					for (std::size_t i = 0; i < thread_size_threshold_ * 64; i++) {
-						task_queue_.enqueue(std::noop_coroutine());
-					}
-					if constexpr (requires (queue_type q) { q.not_empty_cv(); }) {
-						task_queue_.not_empty_cv().notify_all();
-					}
-					for (auto& t : thread_list_) {
-						t->try_join();
-					}
-					std::lock_guard<std::mutex> guard(mtx_);
-					thread_list_.clear();
-					thread_size_.store(0);
+			// drain: every handle already queued, and whatever the workers submit while running them, is run first.
+			// Sleeps pending in a worker's own timers are not waited for: they are cancelled, so the sleepers resume
+			// with cancel_exception and unwind on that worker before it leaves.
+			// abort: workers stop after their current resume, handles that never ran are returned to the caller,
+			// who may resume them elsewhere or destroy them.
+			// Either way parked workers are woken directly and shutdown returns once all of them have been joined.
+			COFLUX_ATTRIBUTES(COFLUX_NODISCARD) std::vector<value_type> shutdown(shutdown_mode how = shutdown_mode::abort) {
+				std::vector<value_type> dropped;
+				bool expected = false;
+				// only one caller gets to stop the pool, and it picks the mode before any worker can see running_ drop
+				if (!running_.load(std::memory_order_acquire) || !stopping_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+					return dropped;
+				}
+				draining_.store(how == shutdown_mode::drain, std::memory_order_seq_cst);
+				running_.store(false, std::memory_order_seq_cst);
+				for (auto& t : thread_list_) {
+					t->try_unpark();
+				}
+				for (auto& t : thread_list_) {
+					t->try_join();
+				}
+				draining_.store(false, std::memory_order_relaxed);
+				std::lock_guard<std::mutex> guard(mtx_);
+				for (auto& t : thread_list_) {
+					t->drop_local(dropped);
+					t->drop_timers();
 				}
+				for (auto& task_queue : task_queues_) {
+					Drop_queue(*task_queue, dropped);
+				}
+				thread_list_.clear();
+				thread_size_.store(0);
+				stopping_.store(false, std::memory_order_release);
+				return dropped;
 			}
 
+			// Untagged work runs at the lowest level.
 			void submit(std::coroutine_handle<> handle) {
-				if (!running_.load(std::memory_order_acquire)) COFLUX_ATTRIBUTES(COFLUX_UNLIKELY) {
+				submit(handle, priority_levels - 1);
+			}
+
+			// Only the highest level may stay in a worker's local queue, lower levels always go through their global queue.
+			void submit(std::coroutine_handle<> handle, std::size_t level) {
+				if (!running_.load(std::memory_order_acquire) && !Draining_from_worker()) COFLUX_ATTRIBUTES(COFLUX_UNLIKELY) {
 					Submit_error();
 				}
-				task_queue_.enqueue(handle);
-				if (mode_ == mode::cached) {
-					if (task_queue_.size_approx() > 32 * thread_size_ && thread_size_ < thread_size_threshold_) {
+				if (level >= priority_levels) COFLUX_ATTRIBUTES(COFLUX_UNLIKELY) {
+					Level_error();
+				}
+				if (level == 0 && !(handle = Try_submit_local(handle))) COFLUX_ATTRIBUTES(COFLUX_LIKELY) {
+					return;
+				}
+				std::size_t node  = Injection_node();
+				auto&       queue = *task_queues_[level * Node_size() + node];
+				queue.enqueue(handle);
+				Unpark_one(node);
+				if (mode_ == mode::cached && running_.load(std::memory_order_relaxed)) {
+					if (queue.size_approx() > Grow_threshold() * thread_size_ && thread_size_ < thread_size_threshold_) {
+						Add_thread(thread_size_);
+					}
+				}
+			}
+
+			// Untagged work runs at the lowest level.
+			void submit_bulk(std::span<const value_type> handles) {
+				submit_bulk(handles, priority_levels - 1);
+			}
+
+			// The whole batch goes to the global queue in one enqueue_bulk (if the queue has one),
+			// then at most one sleeper per handle is woken, and never more than are asleep.
+			void submit_bulk(std::span<const value_type> handles, std::size_t level) {
+				if (!running_.load(std::memory_order_acquire) && !Draining_from_worker()) COFLUX_ATTRIBUTES(COFLUX_UNLIKELY) {
+					Submit_error();
+				}
+				if (level >= priority_levels) COFLUX_ATTRIBUTES(COFLUX_UNLIKELY) {
+					Level_error();
+				}
+				if (handles.empty()) {
+					return;
+				}
+				std::size_t node  = Injection_node();
+				auto&       queue = *task_queues_[level * Node_size() + node];
+				if constexpr (requires{ queue.enqueue_bulk(handles.begin(), handles.size()); }) {
+					queue.enqueue_bulk(handles.begin(), handles.size());
+				}
+				else {
+					for (value_type handle : handles) {
+						queue.enqueue(handle);
+					}
+				}
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				std::size_t wakeups = std::min(handles.size(), idle_size_.load(std::memory_order_relaxed));
+				for (std::size_t i = 0; i < std::max<std::size_t>(wakeups, 1); i++) {
+					Unpark_one(node);
+				}
+				if (mode_ == mode::cached && running_.load(std::memory_order_relaxed)) {
+					if (queue.size_approx() > Grow_threshold() * thread_size_ && thread_size_ < thread_size_threshold_) {
 						Add_thread(thread_size_);
 					}
 				}
@@ -169,7 +410,143 @@ namespace coflux {
 				return thread_size_.load(std::memory_order_acquire);
 			}
 
+			bool running_in_this_thread() const noexcept {
+				thread_type* current = thread_type::current();
+				return current != nullptr && current->owner() == this;
+			}
+
+			// Only from one of our workers: the node goes into that worker's timer heap and fires there.
+			// Returns false anywhere else, the caller falls back to a timer thread.
+			bool try_schedule_local(timer_node* node, typename thread_type::time_point deadline) {
+				thread_type* current = thread_type::current();
+				if (current == nullptr || current->owner() != this) {
+					return false;
+				}
+				current->schedule_local(node, deadline);
+				return true;
+			}
+
+			// One entry per worker slot (cached mode includes the inactive ones), read without stopping anyone.
+			std::vector<worker_stats> stats() {
+				std::lock_guard<std::mutex> guard(mtx_);
+				std::vector<worker_stats> res;
+				res.reserve(thread_list_.size());
+				for (auto& t : thread_list_) {
+					res.push_back(t->stats());
+				}
+				return res;
+			}
+
+			// Only moves when ADAPTIVE_CONTROLLER is set.
+			const controller_type& controller() const noexcept {
+				return controller_;
+			}
+
 		private:
+			// A worker of this pool keeps what it submits locally,
+			// unless someone is sleeping on the global queue and could take it instead.
+			// Returns the handle left for the global queue (nullptr if none).
+			value_type Try_submit_local(value_type handle) {
+				thread_type* current = thread_type::current();
+				if (current == nullptr || current->owner() != this) {
+					return handle;
+				}
+				// A lone worker has nobody to share its local queue with, and reordering against the global queue
+				// can park a continuation that joins forks in front of those forks.
+				if (thread_size_.load(std::memory_order_relaxed) == 1) {
+					return handle;
+				}
+				if (idle_size_.load(std::memory_order_seq_cst) && !current->firing_timers()) {
+					return handle;
+				}
+				return current->try_push_local(handle);
+			}
+
+			// While draining, the coroutines being run may still hand work back to the pool.
+			bool Draining_from_worker() const noexcept {
+				thread_type* current = thread_type::current();
+				return draining_.load(std::memory_order_acquire) && current != nullptr && current->owner() == this;
+			}
+
+			static void Drop_queue(queue_type& queue, std::vector<value_type>& dropped) {
+				std::array<value_type, 64> buffer;
+				while (std::size_t n = queue.try_dequeue_bulk(buffer.begin(), buffer.size())) {
+					dropped.insert(dropped.end(), buffer.begin(), buffer.begin() + n);
+				}
+			}
+
+			// Backlog per thread before cached mode adds one.
+			std::size_t Grow_threshold() const noexcept {
+				if constexpr (constant_traits::ADAPTIVE_CONTROLLER) {
+					return controller_.grow_threshold();
+				}
+				else {
+					return controller_type::initial_grow_threshold;
+				}
+			}
+
+			std::size_t Node_size() const noexcept {
+				return task_queues_.size() / priority_levels;
+			}
+
+			// Workers inject into their own node's queue, other threads into the queue of the node they run on.
+			std::size_t Injection_node() const noexcept {
+				if constexpr (constant_traits::WORKSTEAL_TOPOLOGY_AWARE) {
+					thread_type* current = thread_type::current();
+					if (current != nullptr && current->owner() == this) {
+						return current->home();
+					}
+					return topology_.current_node() % Node_size();
+				}
+				else {
+					return 0;
+				}
+			}
+
+			// Pairs with the worker registering in idle_size_ before its last look at the global queue.
+			// A sleeper of the queue's node is preferred, any sleeper will do otherwise.
+			void Unpark_one(std::size_t node) noexcept {
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if (!idle_size_.load(std::memory_order_relaxed)) COFLUX_ATTRIBUTES(COFLUX_LIKELY) {
+					return;
+				}
+				std::size_t size = thread_list_.size();
+				std::size_t pos  = unpark_pos_.fetch_add(1, std::memory_order_relaxed);
+				if (Node_size() > 1) {
+					for (std::size_t i = 0; i < size; i++) {
+						auto& t = thread_list_[(pos + i) % size];
+						if (t->home() == node && t->try_unpark()) {
+							return;
+						}
+					}
+				}
+				for (std::size_t i = 0; i < size; i++) {
+					if (thread_list_[(pos + i) % size]->try_unpark()) {
+						return;
+					}
+				}
+			}
+
+			// Worker i runs on cpu i (wrapping around), its victims are grouped by distance from that cpu.
+			void Place_threads() {
+				const auto& cpus = topology_.cpus();
+				std::size_t size = thread_list_.size();
+				for (std::size_t i = 0; i < size; i++) {
+					std::size_t cpu = i % cpus.size();
+					std::vector<std::vector<std::size_t>> tiers(4);
+					for (std::size_t j = 0; j < size; j++) {
+						if (j == i) {
+							continue;
+						}
+						// two workers on one cpu (more workers than cpus) are as close as SMT siblings
+						int dist = std::max<int>(topology_.distance_between(cpu, j % cpus.size()), topology::smt_sibling);
+						tiers[dist - topology::smt_sibling].push_back(j);
+					}
+					std::erase_if(tiers, [](const auto& tier) { return tier.empty(); });
+					thread_list_[i]->place(cpus[cpu].id, cpus[cpu].node % Node_size(), std::move(tiers));
+				}
+			}
+
 			void Add_thread(std::size_t old_size) {
 				std::lock_guard<std::mutex> guard(mtx_);
 				if (thread_size_ != old_size) {
@@ -178,8 +555,7 @@ namespace coflux {
 				for (int i = 0; i < thread_size_threshold_; i++) {
 					if (thread_list_[i]->active() == false) {
 						thread_list_[i]->try_join();
-						thread_list_[i]->enable(task_queue_, mode_, running_, thread_size_,basic_thread_size_, thread_list_);
-						thread_size_++;
+						thread_list_[i]->enable(*this);
 						return;
 					}
 				}
@@ -189,14 +565,24 @@ namespace coflux {
 				throw std::runtime_error("Thread_pool can't take on a new task.");
 			}
 
+			COFLUX_ATTRIBUTES(COFLUX_NORETURN) static void Level_error() {
+				throw std::runtime_error("Priority level out of range.");
+			}
+
 		private:
 			mode									  mode_;
-			std::atomic_bool						  running_ = false;
+			std::atomic_bool						  running_  = false;
+			std::atomic_bool						  draining_ = false;
+			std::atomic_bool						  stopping_ = false;
 			std::vector<std::unique_ptr<thread_type>> thread_list_;
-			queue_type								  task_queue_;
+			std::vector<std::unique_ptr<queue_type>>  task_queues_;
+			topology								  topology_;
 			std::size_t								  basic_thread_size_;
 			std::size_t								  thread_size_threshold_;
 			std::atomic_size_t						  thread_size_ = 0;
+			std::atomic_size_t						  idle_size_   = 0;
+			std::atomic_size_t						  unpark_pos_  = 0;
+			controller_type							  controller_;
 			std::mutex								  mtx_;
 		};
 	}
@@ -0,0 +1,256 @@
+#if defined(_MSC_VER) && _MSC_VER > 1000 || defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 3)
+#pragma once
+#endif
+
+#ifndef COFLUX_TIMER_NODE_HPP
+#define COFLUX_TIMER_NODE_HPP
+
+#include "../detail/forward_declaration.hpp"
+#include <algorithm>
+
+namespace coflux {
+	namespace concurrent {
+		/*
+		*			armed --try_fire (timer)--> fired      invoke(node, true), or invoke(node, false) if dropped by shutdown
+		*			  |
+		*			  +----cancel_timer (anyone)--> cancelled   the timer unlinks it on its own thread, then invoke(node, false)
+		*
+		*			The timer owns the links from schedule until the node is invoked, exactly once.
+		*			Whoever embeds the node (e.g. an awaiter in a coroutine frame) keeps it alive until then.
+		*/
+		struct timer_node {
+			enum state : int {
+				armed, fired, cancelled
+			};
+
+			static constexpr std::size_t unlinked = std::size_t(-1);
+
+			timer_node*   prev        = nullptr;
+			timer_node*   next        = nullptr;
+			timer_node*   cancel_next = nullptr;
+			std::uint64_t due         = 0;				// tick, used by timing_wheel
+			std::size_t   index       = unlinked;		// heap position or wheel list, owned by the timer
+			std::chrono::steady_clock::time_point deadline{};
+			std::atomic<int> st       = armed;
+			void        (*invoke)(timer_node*, bool /* fire */) = nullptr;
+
+			// Stamped by the timer on schedule, see cancel_timer.
+			void*         timer       = nullptr;
+			void        (*revoke)(void* /* timer */, timer_node*) = nullptr;
+
+			// Only the timer calls this, right before it would invoke the node.
+			bool try_fire() noexcept {
+				int expected = armed;
+				return st.compare_exchange_strong(expected, fired, std::memory_order_acq_rel, std::memory_order_acquire);
+			}
+		};
+
+		// Returns false if the node has fired (or is about to). Otherwise its timer gives it back through invoke(node, false),
+		// from the timer's own thread once nothing there refers to it any more. Only for nodes that have been scheduled.
+		inline bool cancel_timer(timer_node* node) noexcept {
+			int expected = timer_node::armed;
+			if (!node->st.compare_exchange_strong(expected, timer_node::cancelled, std::memory_order_acq_rel, std::memory_order_acquire)) {
+				return false;
+			}
+			node->revoke(node->timer, node);
+			return true;
+		}
+
+		// Cancelled nodes on their way back to the timer's thread, linked through cancel_next.
+		class timer_cancel_inbox {
+		public:
+			void push(timer_node* node) noexcept {
+				timer_node* head = head_.load(std::memory_order_relaxed);
+				do {
+					node->cancel_next = head;
+				} while (!head_.compare_exchange_weak(head, node, std::memory_order_seq_cst, std::memory_order_relaxed));
+			}
+
+			timer_node* take() noexcept {
+				if (!head_.load(std::memory_order_relaxed)) {
+					return nullptr;
+				}
+				return head_.exchange(nullptr, std::memory_order_acq_rel);
+			}
+
+			bool empty() const noexcept {
+				return head_.load(std::memory_order_seq_cst) == nullptr;
+			}
+
+		private:
+			std::atomic<timer_node*> head_ = nullptr;
+		};
+
+		// Binary min-heap on deadline which keeps every node's position in node->index, so a cancelled node leaves in O(log n).
+		class timer_heap {
+		public:
+			bool empty() const noexcept {
+				return nodes_.empty();
+			}
+
+			std::size_t size() const noexcept {
+				return nodes_.size();
+			}
+
+			timer_node* top() const noexcept {
+				return nodes_.front();
+			}
+
+			void push(timer_node* node) {
+				nodes_.push_back(node);
+				Sift_up(nodes_.size() - 1);
+			}
+
+			timer_node* pop() noexcept {
+				timer_node* node = nodes_.front();
+				erase(node);
+				return node;
+			}
+
+			void erase(timer_node* node) noexcept {
+				std::size_t pos  = node->index;
+				timer_node* last = nodes_.back();
+				nodes_.pop_back();
+				node->index = timer_node::unlinked;
+				if (last != node) {
+					Place(pos, last);
+					Sift_up(pos);
+					Sift_down(last->index);
+				}
+			}
+
+		private:
+			void Place(std::size_t pos, timer_node* node) noexcept {
+				nodes_[pos] = node;
+				node->index = pos;
+			}
+
+			void Sift_up(std::size_t pos) noexcept {
+				timer_node* node = nodes_[pos];
+				while (pos > 0) {
+					std::size_t parent = (pos - 1) / 2;
+					if (!(node->deadline < nodes_[parent]->deadline)) {
+						break;
+					}
+					Place(pos, nodes_[parent]);
+					pos = parent;
+				}
+				Place(pos, node);
+			}
+
+			void Sift_down(std::size_t pos) noexcept {
+				timer_node* node = nodes_[pos];
+				std::size_t size = nodes_.size();
+				while (true) {
+					std::size_t child = 2 * pos + 1;
+					if (child >= size) {
+						break;
+					}
+					if (child + 1 < size && nodes_[child + 1]->deadline < nodes_[child]->deadline) {
+						child++;
+					}
+					if (!(nodes_[child]->deadline < node->deadline)) {
+						break;
+					}
+					Place(pos, nodes_[child]);
+					pos = child;
+				}
+				Place(pos, node);
+			}
+
+			std::vector<timer_node*> nodes_;
+		};
+
+		// Rounds a deadline up to the next multiple of slack on the clock's own epoch. Timers that may run up to slack
+		// late then share one deadline per window, so the timer wakes once for all of them and never before any is due.
+		inline std::chrono::steady_clock::time_point coalesce(std::chrono::steady_clock::time_point deadline,
+			std::chrono::steady_clock::duration slack) noexcept {
+			if (slack <= std::chrono::steady_clock::duration::zero()) {
+				return deadline;
+			}
+			auto since_epoch = deadline.time_since_epoch();
+			auto rounded     = since_epoch / slack * slack;
+			return std::chrono::steady_clock::time_point(rounded < since_epoch ? rounded + slack : rounded);
+		}
+
+		/*
+		*			Resumes collected during one firing pass of a timer thread.
+		*			While a pass is running, current() points at the thread's batch and a sleeper's invoke adds its handle
+		*			here instead of executing it, flush() then hands every executor its share in one execute_bulk.
+		*/
+		class timer_batch {
+		public:
+			using dispatch_type = void (*)(void* /* executor */, std::span<const std::coroutine_handle<>>);
+
+			static timer_batch*& current() noexcept {
+				thread_local timer_batch* batch = nullptr;
+				return batch;
+			}
+
+			void add(void* executor, dispatch_type dispatch, std::coroutine_handle<> handle) {
+				entries_.push_back({ executor, dispatch, handle });
+			}
+
+			// In deadline order within each executor.
+			void flush() {
+				if (entries_.empty()) {
+					return;
+				}
+				std::stable_sort(entries_.begin(), entries_.end(), [](const entry& a, const entry& b) {
+					return std::less<void*>()(a.executor, b.executor);
+					});
+				for (std::size_t first = 0; first < entries_.size();) {
+					std::size_t last = first;
+					handles_.clear();
+					while (last < entries_.size() && entries_[last].executor == entries_[first].executor) {
+						handles_.push_back(entries_[last].handle);
+						last++;
+					}
+					entries_[first].dispatch(entries_[first].executor, handles_);
+					first = last;
+				}
+				entries_.clear();
+			}
+
+		private:
+			struct entry {
+				void*                   executor;
+				dispatch_type           dispatch;
+				std::coroutine_handle<> handle;
+			};
+
+			std::vector<entry>                   entries_;
+			std::vector<std::coroutine_handle<>> handles_;
+		};
+
+		// Heap node for the callable submit paths.
+		template <typename Func>
+		struct timer_task : timer_node {
+			explicit timer_task(Func&& func) : func_(std::move(func)) {
+				this->invoke = &timer_task::Invoke;
+			}
+
+			static void Invoke(timer_node* node, bool fire) {
+				std::unique_ptr<timer_task> self(static_cast<timer_task*>(node));
+				if (fire) {
+					self->func_();
+				}
+			}
+
+			Func func_;
+		};
+
+		template <typename Func, typename... Args>
+		timer_node* make_timer_task(Func&& func, Args&& ...args) {
+			if constexpr (sizeof...(Args)) {
+				auto bound = std::bind(std::forward<Func>(func), std::forward<Args>(args)...);
+				return new timer_task<decltype(bound)>(std::move(bound));
+			}
+			else {
+				return new timer_task<std::decay_t<Func>>(std::decay_t<Func>(std::forward<Func>(func)));
+			}
+		}
+	}
+}
+
+#endif // !COFLUX_TIMER_NODE_HPP
\ No newline at end of file
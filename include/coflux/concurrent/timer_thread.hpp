@@ -6,6 +6,8 @@
 #define COFLUX_TIMER_THREAD_HPP
 
 #include "../detail/forward_declaration.hpp"
+#include "timer_node.hpp"
+#include "timer_waiter.hpp"
 
 namespace coflux {
 	namespace concurrent {
@@ -13,19 +15,12 @@ namespace coflux {
 		public:
 			using clock      = std::chrono::steady_clock;
 			using time_point = clock::time_point;
-			using duration   = std::chrono::milliseconds;
-			using package    = std::pair<time_point, std::function<void()>>;
-
-			struct package_greater {
-				bool operator()(const package& a, const package& b) const {
-					return a.first > b.first;
-				}
-			};
-
-			using queue_type = std::priority_queue<package, std::vector<package>, package_greater>;
+			using duration   = clock::duration;
+			using queue_type = timer_heap;
 		
 		public:
-			timer_thread() {
+			// Deadlines are coalesced onto a grid of slack (see coalesce), zero keeps every deadline exact.
+			explicit timer_thread(duration slack = duration::zero()) : slack_(slack) {
 				run();
 			}
 			~timer_thread() {
@@ -45,52 +40,121 @@ namespace coflux {
 
 			void shutdown() {
 				if (running_.exchange(false)) {
-					queue_cv_.notify_one();
+					waiter_.notify();
 					if (thread_.joinable()) {
 						thread_.join();
 					}
+					// Cancellations that made it in are still honoured, timers that haven't fired are dropped.
+					std::unique_lock<std::mutex> lock(queue_mtx_);
+					Handle_cancels(lock);
+					while (!queue_.empty()) {
+						timer_node* node = queue_.pop();
+						if (node->try_fire()) {
+							node->invoke(node, false);
+						}
+					}
 				}
 			}
 
 			template <typename Func, typename... Args>
 			void submit(Func&& func, const duration& timer, Args&& ...args) {
 				if (timer != duration()) {
-					std::unique_lock<std::mutex> lock(queue_mtx_);
-					auto new_timer = clock::now() + timer;
-					queue_.emplace(new_timer, std::bind(std::forward<Func>(func), std::forward<Args>(args)...));
-					queue_cv_.notify_one();
+					schedule(make_timer_task(std::forward<Func>(func), std::forward<Args>(args)...), clock::now() + timer);
 				}
 				else {
 					func(std::forward<Args>(args)...);
 				}
 			}
 
+			// Links a caller-owned node, no allocation beyond the queue's own storage.
+			// The thread is only woken if the new timer becomes the earliest one.
+			void schedule(timer_node* node, time_point deadline) {
+				deadline = coalesce(deadline, slack_);
+				node->deadline = deadline;
+				node->timer    = this;
+				node->revoke   = &timer_thread::Revoke;
+				bool earliest;
+				{
+					std::lock_guard<std::mutex> guard(queue_mtx_);
+					earliest = queue_.empty() || deadline < queue_.top()->deadline;
+					queue_.push(node);
+				}
+				if (earliest) {
+					waiter_.notify();
+				}
+			}
+
 			void work() {
 				std::unique_lock<std::mutex> lock(queue_mtx_);
 				while (running_.load(std::memory_order_acquire)) {
-					queue_cv_.wait(lock, [this] { return !queue_.empty() || !running_.load(std::memory_order_acquire); });
-					if (!running_.load(std::memory_order_acquire)) break;
-					while (running_.load(std::memory_order_acquire) && !queue_.empty() && queue_.top().first <= clock::now()) {
-						auto task_package = queue_.top();
-						queue_.pop();
+					Handle_cancels(lock);
+					// Everything due is taken in one go and fired outside the lock, the resumes it produces
+					// reach each executor as one batch.
+					time_point now = clock::now();
+					while (!queue_.empty() && queue_.top()->deadline <= now) {
+						timer_node* node = queue_.pop();
+						// a cancelled node is already on its way back through cancels_
+						if (node->try_fire()) {
+							due_.push_back(node);
+						}
+					}
+					if (!due_.empty()) {
 						lock.unlock();
-						task_package.second();
+						Fire_due();
 						lock.lock();
 					}
-
-					if (running_.load(std::memory_order_acquire) && !queue_.empty()) {
-						auto next_timepoint = queue_.top().first;
-						queue_cv_.wait_until(lock, next_timepoint);
+					time_point next_timepoint = queue_.empty() ? time_point::max() : queue_.top()->deadline;
+					lock.unlock();
+					// a notify racing in after the unlock is sticky, nothing scheduled or cancelled meanwhile is missed
+					if (running_.load(std::memory_order_acquire) && cancels_.empty()) {
+						waiter_.wait_until(next_timepoint);
 					}
+					lock.lock();
 				}
 			}
 
 		private:
-			std::atomic_bool        running_ = false;
-			std::condition_variable queue_cv_;
-			std::thread             thread_;
-			queue_type              queue_;
-			std::mutex              queue_mtx_;
+			static void Revoke(void* self, timer_node* node) noexcept {
+				auto* thread = static_cast<timer_thread*>(self);
+				thread->cancels_.push(node);
+				thread->waiter_.notify();
+			}
+
+			void Fire_due() {
+				timer_batch::current() = &batch_;
+				for (timer_node* node : due_) {
+					node->invoke(node, true);
+				}
+				timer_batch::current() = nullptr;
+				due_.clear();
+				batch_.flush();
+			}
+
+			void Handle_cancels(std::unique_lock<std::mutex>& lock) {
+				timer_node* node = cancels_.take();
+				while (node) {
+					timer_node* next = node->cancel_next;
+					if (node->index != timer_node::unlinked) {
+						queue_.erase(node);
+					}
+					lock.unlock();
+					node->invoke(node, false);
+					lock.lock();
+					node = next;
+				}
+			}
+
+			const duration     slack_;
+			std::atomic_bool   running_ = false;
+			timer_waiter       waiter_;
+			std::thread        thread_;
+			queue_type         queue_;
+			timer_cancel_inbox cancels_;
+			std::mutex         queue_mtx_;
+
+			// Owned by the timer thread.
+			std::vector<timer_node*> due_;
+			timer_batch              batch_;
 		};
 	}
 }
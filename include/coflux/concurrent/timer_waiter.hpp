@@ -0,0 +1,134 @@
+#if defined(_MSC_VER) && _MSC_VER > 1000 || defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 3)
+#pragma once
+#endif
+
+#ifndef COFLUX_TIMER_WAITER_HPP
+#define COFLUX_TIMER_WAITER_HPP
+
+#include "../detail/forward_declaration.hpp"
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+namespace coflux {
+	namespace concurrent {
+		class timer_waiter {
+		public:
+			/*
+			*			Sleeps until an absolute steady_clock deadline or until notify, whichever comes first.
+			*			On linux a timerfd (armed with TFD_TIMER_ABSTIME on CLOCK_MONOTONIC, which is what
+			*			steady_clock reads) and an eventfd are waited on with epoll: the expiry is a plain hrtimer,
+			*			so wakeups land within microseconds instead of whatever a condition variable's timed wait gives.
+			*			Anywhere else, or if the descriptors can't be created, a condition variable does the job.
+			*			notify is sticky: one that lands before wait_until makes it return immediately.
+			*/
+			using clock      = std::chrono::steady_clock;
+			using time_point = clock::time_point;
+
+		public:
+			timer_waiter() {
+#ifdef __linux__
+				epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+				timer_fd_ = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+				event_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+				if (epoll_fd_ < 0 || timer_fd_ < 0 || event_fd_ < 0 || !Watch(timer_fd_) || !Watch(event_fd_)) {
+					Close();
+				}
+#endif
+			}
+			~timer_waiter() {
+#ifdef __linux__
+				Close();
+#endif
+			}
+
+			timer_waiter(const timer_waiter&)            = delete;
+			timer_waiter(timer_waiter&&)                 = delete;
+			timer_waiter& operator=(const timer_waiter&) = delete;
+			timer_waiter& operator=(timer_waiter&&)      = delete;
+
+			void notify() noexcept {
+#ifdef __linux__
+				if (epoll_fd_ >= 0) {
+					std::uint64_t one = 1;
+					[[maybe_unused]] auto n = ::write(event_fd_, &one, sizeof(one));
+					return;
+				}
+#endif
+				{
+					std::lock_guard<std::mutex> guard(mtx_);
+					notified_ = true;
+				}
+				cv_.notify_one();
+			}
+
+			// time_point::max() waits for notify only.
+			void wait_until(time_point deadline) {
+#ifdef __linux__
+				if (epoll_fd_ >= 0) {
+					Wait_epoll(deadline);
+					return;
+				}
+#endif
+				std::unique_lock<std::mutex> lock(mtx_);
+				if (deadline == time_point::max()) {
+					cv_.wait(lock, [this] { return notified_; });
+				}
+				else {
+					cv_.wait_until(lock, deadline, [this] { return notified_; });
+				}
+				notified_ = false;
+			}
+
+		private:
+#ifdef __linux__
+			bool Watch(int fd) noexcept {
+				epoll_event ev{};
+				ev.events  = EPOLLIN;
+				ev.data.fd = fd;
+				return ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) == 0;
+			}
+
+			void Wait_epoll(time_point deadline) {
+				itimerspec spec{};
+				if (deadline != time_point::max()) {
+					auto since_epoch = std::max(deadline.time_since_epoch(), clock::duration(1));
+					auto seconds     = std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+					spec.it_value.tv_sec  = static_cast<time_t>(seconds.count());
+					spec.it_value.tv_nsec = static_cast<long>(std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch - seconds).count());
+				}
+				// An all-zero value disarms the timer.
+				::timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+				epoll_event events[2];
+				// EINTR only makes the caller look at its queue once more.
+				::epoll_wait(epoll_fd_, events, 2, -1);
+				std::uint64_t drained;
+				[[maybe_unused]] auto t = ::read(timer_fd_, &drained, sizeof(drained));
+				[[maybe_unused]] auto e = ::read(event_fd_, &drained, sizeof(drained));
+			}
+
+			void Close() noexcept {
+				for (int* fd : { &epoll_fd_, &timer_fd_, &event_fd_ }) {
+					if (*fd >= 0) {
+						::close(*fd);
+						*fd = -1;
+					}
+				}
+			}
+
+			int epoll_fd_ = -1;
+			int timer_fd_ = -1;
+			int event_fd_ = -1;
+#endif
+			std::mutex              mtx_;
+			std::condition_variable cv_;
+			bool                    notified_ = false;
+		};
+	}
+}
+
+#endif // !COFLUX_TIMER_WAITER_HPP
\ No newline at end of file
@@ -0,0 +1,376 @@
+#if defined(_MSC_VER) && _MSC_VER > 1000 || defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 3)
+#pragma once
+#endif
+
+#ifndef COFLUX_TIMING_WHEEL_HPP
+#define COFLUX_TIMING_WHEEL_HPP
+
+#include "../detail/forward_declaration.hpp"
+#include "parker.hpp"
+#include "timer_node.hpp"
+#include <bit>
+
+namespace coflux {
+	namespace concurrent {
+		enum class timer_backend {
+			heap, wheel
+		};
+
+		struct default_timing_wheel_constants {
+			static constexpr std::size_t TIMING_WHEEL_TICK_MICROSECONDS = 1000;
+			// Resolution of the wheel, a timer fires on the first tick at or after its deadline.
+
+			static constexpr std::size_t TIMING_WHEEL_SLOT_BITS         = 8;
+			// Every level has 2^TIMING_WHEEL_SLOT_BITS slots.
+
+			static constexpr std::size_t TIMING_WHEEL_LEVELS            = 4;
+			// Timers more than 2^(TIMING_WHEEL_SLOT_BITS * TIMING_WHEEL_LEVELS) ticks away wait in an overflow list.
+		};
+
+		template <typename Constants>
+		struct timing_wheel_constant_traits {
+			static constexpr std::size_t TIMING_WHEEL_TICK_MICROSECONDS = []() consteval -> std::size_t {
+				if constexpr (requires{ Constants::TIMING_WHEEL_TICK_MICROSECONDS; }) {
+					return Constants::TIMING_WHEEL_TICK_MICROSECONDS;
+				}
+				else {
+					return default_timing_wheel_constants::TIMING_WHEEL_TICK_MICROSECONDS;
+				}
+			}();
+
+			static constexpr std::size_t TIMING_WHEEL_SLOT_BITS = []() consteval -> std::size_t {
+				if constexpr (requires{ Constants::TIMING_WHEEL_SLOT_BITS; }) {
+					return Constants::TIMING_WHEEL_SLOT_BITS;
+				}
+				else {
+					return default_timing_wheel_constants::TIMING_WHEEL_SLOT_BITS;
+				}
+			}();
+
+			static constexpr std::size_t TIMING_WHEEL_LEVELS = []() consteval -> std::size_t {
+				if constexpr (requires{ Constants::TIMING_WHEEL_LEVELS; }) {
+					return Constants::TIMING_WHEEL_LEVELS;
+				}
+				else {
+					return default_timing_wheel_constants::TIMING_WHEEL_LEVELS;
+				}
+			}();
+		};
+
+		template <typename Constants = default_timing_wheel_constants>
+		class timing_wheel {
+		public:
+			/*
+			*			Hierarchical timing wheel on a thread of its own.
+			*			Producers push nodes onto a lock-free inbox (one CAS) and only wake the thread if the new
+			*			timer is due before the tick it sleeps until. The thread moves the inbox into the wheel:
+			*			a node goes to the level of the highest digit (SLOT_BITS wide) in which its due tick differs
+			*			from the current tick, so insert and expiry are O(1) and every slot of a level above 0 is
+			*			cascaded one level down exactly when the current tick reaches it.
+			*/
+			using constant_traits = timing_wheel_constant_traits<Constants>;
+			using clock           = std::chrono::steady_clock;
+			using time_point      = clock::time_point;
+			using duration        = clock::duration;
+
+			static constexpr std::chrono::microseconds tick = std::chrono::microseconds(constant_traits::TIMING_WHEEL_TICK_MICROSECONDS);
+
+			static constexpr std::size_t slot_bits = constant_traits::TIMING_WHEEL_SLOT_BITS;
+			static constexpr std::size_t levels    = constant_traits::TIMING_WHEEL_LEVELS;
+			static constexpr std::size_t slots     = std::size_t(1) << slot_bits;
+			static constexpr std::size_t words     = (slots + 63) / 64;
+
+			static constexpr std::uint64_t slot_mask      = slots - 1;
+			static constexpr std::size_t   overflow_index = levels * slots;
+			static constexpr std::uint64_t none           = std::uint64_t(-1);
+
+			static_assert(tick.count() > 0,               "TIMING_WHEEL_TICK_MICROSECONDS should be larger than zero.");
+			static_assert(slot_bits && levels,            "TIMING_WHEEL_SLOT_BITS and TIMING_WHEEL_LEVELS should be larger than zero.");
+			static_assert(slot_bits * levels < 64,        "The wheel should span less than 2^64 ticks.");
+
+			// Deadlines are coalesced onto a grid of slack (see coalesce) before they are turned into ticks.
+			explicit timing_wheel(duration slack = duration::zero()) : start_(clock::now()), slack_(slack) {
+				run();
+			}
+			~timing_wheel() {
+				shutdown();
+			}
+
+			timing_wheel(const timing_wheel&)            = delete;
+			timing_wheel(timing_wheel&&)                 = delete;
+			timing_wheel& operator=(const timing_wheel&) = delete;
+			timing_wheel& operator=(timing_wheel&&)      = delete;
+
+			void run() {
+				if (!running_.exchange(true)) {
+					thread_ = std::thread(&timing_wheel::work, this);
+				}
+			}
+
+			// Cancellations that made it in are still honoured, timers that haven't fired are dropped, like timer_thread.
+			void shutdown() {
+				if (running_.exchange(false)) {
+					parker_.try_unpark();
+					if (thread_.joinable()) {
+						thread_.join();
+					}
+					Drop_all();
+				}
+			}
+
+			template <typename Func, typename... Args>
+			void submit(Func&& func, const duration& timer, Args&& ...args) {
+				if (timer == duration()) {
+					func(std::forward<Args>(args)...);
+					return;
+				}
+				schedule(make_timer_task(std::forward<Func>(func), std::forward<Args>(args)...), clock::now() + timer);
+			}
+
+			// Links a caller-owned node, no allocation at all.
+			void schedule(timer_node* node, time_point deadline) noexcept {
+				node->timer  = this;
+				node->revoke = &timing_wheel::Revoke;
+				Push(node, deadline);
+			}
+
+		private:
+			void work() {
+				while (running_.load(std::memory_order_seq_cst)) {
+					// Cancels are taken before the inbox: a node is pushed before it can be cancelled,
+					// so every node taken here is already in the inbox or the wheel.
+					timer_node* cancelled = cancels_.take();
+					// the resumes of one pass reach each executor as one batch
+					timer_batch::current() = &batch_;
+					Drain_inbox();
+					Drain_cancels(cancelled);
+					Advance(Now_tick());
+					timer_batch::current() = nullptr;
+					batch_.flush();
+					std::uint64_t next = Next_event();
+					wake_tick_.store(next, std::memory_order_seq_cst);
+					parker_.prepare_park();
+					if (inbox_.load(std::memory_order_seq_cst) || !cancels_.empty() || !running_.load(std::memory_order_seq_cst)) {
+						parker_.cancel_park();
+					}
+					else if (next == none) {
+						parker_.park();
+					}
+					else {
+						parker_.park_for(start_ + next * tick - clock::now());
+					}
+					wake_tick_.store(0, std::memory_order_seq_cst);
+				}
+			}
+
+			static void Revoke(void* self, timer_node* node) noexcept {
+				auto* wheel = static_cast<timing_wheel*>(self);
+				wheel->cancels_.push(node);
+				wheel->parker_.try_unpark();
+			}
+
+			void Push(timer_node* node, time_point deadline) noexcept {
+				node->due = Due(coalesce(deadline, slack_));
+				timer_node* head = inbox_.load(std::memory_order_relaxed);
+				do {
+					node->next = head;
+				} while (!inbox_.compare_exchange_weak(head, node, std::memory_order_seq_cst, std::memory_order_relaxed));
+				// The thread is awake (wake_tick_ == 0) or sleeps past this timer.
+				if (node->due < wake_tick_.load(std::memory_order_seq_cst)) {
+					parker_.try_unpark();
+				}
+			}
+
+			std::uint64_t Due(time_point deadline) const noexcept {
+				if (deadline <= start_) {
+					return 0;
+				}
+				auto elapsed = deadline - start_;
+				return std::uint64_t(elapsed / tick) + (elapsed % tick != clock::duration::zero());
+			}
+
+			std::uint64_t Now_tick() const noexcept {
+				return std::uint64_t((clock::now() - start_) / tick);
+			}
+
+			void Drain_inbox() {
+				timer_node* node = inbox_.exchange(nullptr, std::memory_order_acq_rel);
+				while (node) {
+					timer_node* next = node->next;
+					if (node->due > current_) {
+						Insert(node);
+					}
+					else if (node->try_fire()) {
+						node->invoke(node, true);
+					}
+					node = next;
+				}
+			}
+
+			// A cancelled node is either linked or has been taken out to fire (and lost the race).
+			void Drain_cancels(timer_node* node) {
+				while (node) {
+					timer_node* next = node->cancel_next;
+					if (node->index != timer_node::unlinked) {
+						Unlink(node);
+					}
+					node->invoke(node, false);
+					node = next;
+				}
+			}
+
+			void Insert(timer_node* node) noexcept {
+				std::uint64_t diff = node->due ^ current_;
+				if (diff >> (slot_bits * levels)) {
+					Link(overflow_, node);
+					node->index = overflow_index;
+					return;
+				}
+				std::size_t level = diff ? std::size_t(63 - std::countl_zero(diff)) / slot_bits : 0;
+				std::size_t slot  = std::size_t((node->due >> (slot_bits * level)) & slot_mask);
+				Link(slots_[level][slot], node);
+				node->index = level * slots + slot;
+				occupied_[level][slot / 64] |= std::uint64_t(1) << (slot % 64);
+			}
+
+			void Unlink(timer_node* node) noexcept {
+				timer_node*& head = node->index == overflow_index ? overflow_ : slots_[node->index / slots][node->index % slots];
+				if (node->prev) {
+					node->prev->next = node->next;
+				}
+				else {
+					head = node->next;
+				}
+				if (node->next) {
+					node->next->prev = node->prev;
+				}
+				if (!head && node->index != overflow_index) {
+					std::size_t level = node->index / slots, slot = node->index % slots;
+					occupied_[level][slot / 64] &= ~(std::uint64_t(1) << (slot % 64));
+				}
+				node->index = timer_node::unlinked;
+			}
+
+			// The first tick after current_ at which some slot (or the overflow list) has to be looked at.
+			std::uint64_t Next_event() const noexcept {
+				std::uint64_t next = none;
+				for (std::size_t level = 0; level < levels; level++) {
+					std::size_t shift = slot_bits * level;
+					std::size_t slot  = Next_occupied(level, std::size_t((current_ >> shift) & slot_mask) + 1);
+					if (slot < slots) {
+						std::uint64_t base = (current_ >> (shift + slot_bits)) << (shift + slot_bits);
+						next = std::min(next, base | (std::uint64_t(slot) << shift));
+					}
+				}
+				if (overflow_) {
+					std::size_t shift = slot_bits * levels;
+					next = std::min(next, ((current_ >> shift) + 1) << shift);
+				}
+				return next;
+			}
+
+			std::size_t Next_occupied(std::size_t level, std::size_t from) const noexcept {
+				for (std::size_t word = from / 64; word < words; word++) {
+					std::uint64_t bits = occupied_[level][word];
+					if (word == from / 64) {
+						bits &= ~std::uint64_t(0) << (from % 64);
+					}
+					if (bits) {
+						return word * 64 + std::size_t(std::countr_zero(bits));
+					}
+				}
+				return slots;
+			}
+
+			void Advance(std::uint64_t now) {
+				for (std::uint64_t next = Next_event(); next <= now; next = Next_event()) {
+					current_ = next;
+					if (overflow_ && (next & ((std::uint64_t(1) << (slot_bits * levels)) - 1)) == 0) {
+						Reinsert(std::exchange(overflow_, nullptr));
+					}
+					for (std::size_t level = levels - 1; level > 0; level--) {
+						if ((next & ((std::uint64_t(1) << (slot_bits * level)) - 1)) == 0) {
+							Reinsert(Take(level, std::size_t((next >> (slot_bits * level)) & slot_mask)));
+						}
+					}
+					timer_node* node = Take(0, std::size_t(next & slot_mask));
+					while (node) {
+						timer_node* following = node->next;
+						node->index = timer_node::unlinked;
+						// a cancelled node is already on its way back through cancels_
+						if (node->try_fire()) {
+							node->invoke(node, true);
+						}
+						node = following;
+					}
+				}
+				current_ = std::max(current_, now);
+			}
+
+			void Reinsert(timer_node* node) noexcept {
+				while (node) {
+					timer_node* next = node->next;
+					Insert(node);
+					node = next;
+				}
+			}
+
+			timer_node* Take(std::size_t level, std::size_t slot) noexcept {
+				occupied_[level][slot / 64] &= ~(std::uint64_t(1) << (slot % 64));
+				return std::exchange(slots_[level][slot], nullptr);
+			}
+
+			static void Link(timer_node*& head, timer_node* node) noexcept {
+				node->prev = nullptr;
+				node->next = head;
+				if (head) {
+					head->prev = node;
+				}
+				head = node;
+			}
+
+			void Drop_all() {
+				auto drop = [](timer_node* node) {
+					while (node) {
+						timer_node* next = node->next;
+						node->index = timer_node::unlinked;
+						if (node->try_fire()) {
+							node->invoke(node, false);
+						}
+						node = next;
+					}
+					};
+				timer_node* cancelled = cancels_.take();
+				Reinsert(inbox_.exchange(nullptr, std::memory_order_acq_rel));
+				Drain_cancels(cancelled);
+				drop(std::exchange(overflow_, nullptr));
+				for (std::size_t level = 0; level < levels; level++) {
+					for (std::size_t slot = 0; slot < slots; slot++) {
+						drop(Take(level, slot));
+					}
+				}
+				Drain_cancels(cancels_.take());
+			}
+
+		private:
+			const time_point start_;
+			const duration   slack_;
+
+			std::atomic_bool            running_   = false;
+			std::atomic<timer_node*>    inbox_     = nullptr;
+			std::atomic<std::uint64_t>  wake_tick_ = 0;
+			timer_cancel_inbox          cancels_;
+			parker                      parker_;
+			std::thread                 thread_;
+
+			// Owned by the wheel thread.
+			std::uint64_t current_  = 0;
+			timer_node*   overflow_ = nullptr;
+			timer_node*   slots_[levels][slots]    = {};
+			std::uint64_t occupied_[levels][words] = {};
+			timer_batch   batch_;
+		};
+	}
+}
+
+#endif // !COFLUX_TIMING_WHEEL_HPP
\ No newline at end of file
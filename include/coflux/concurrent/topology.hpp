@@ -0,0 +1,247 @@
+#if defined(_MSC_VER) && _MSC_VER > 1000 || defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 3)
+#pragma once
+#endif
+
+#ifndef COFLUX_TOPOLOGY_HPP
+#define COFLUX_TOPOLOGY_HPP
+
+#include "../detail/forward_declaration.hpp"
+#include <fstream>
+#include <string>
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace coflux {
+	namespace concurrent {
+		class topology {
+		public:
+			/*
+			*			cpu -> core (SMT siblings) -> llc (shared last level cache) -> node (NUMA)
+			*			Read from /sys/devices/system on linux. Anywhere else, or if sysfs is missing,
+			*			every cpu is its own core and they all share one llc on one node.
+			*/
+			struct cpu_info {
+				int         id   = 0;
+				std::size_t core = 0;
+				std::size_t llc  = 0;
+				std::size_t node = 0;
+			};
+
+			enum distance : int {
+				self, smt_sibling, same_llc, same_node, remote
+			};
+
+		public:
+			topology()  = default;
+			~topology() = default;
+
+			topology(const topology&)            = default;
+			topology(topology&&)                 = default;
+			topology& operator=(const topology&) = default;
+			topology& operator=(topology&&)      = default;
+
+			static topology detect() {
+				topology topo;
+#ifdef __linux__
+				topo.Read_sysfs();
+#endif
+				if (topo.cpus_.empty()) {
+					topo.Fallback();
+				}
+				return topo;
+			}
+
+			const std::vector<cpu_info>& cpus() const noexcept {
+				return cpus_;
+			}
+
+			std::size_t node_size() const noexcept {
+				return node_size_;
+			}
+
+			// `a` and `b` are positions in cpus().
+			distance distance_between(std::size_t a, std::size_t b) const noexcept {
+				const cpu_info& x = cpus_[a];
+				const cpu_info& y = cpus_[b];
+				if (a == b) {
+					return self;
+				}
+				if (x.core == y.core) {
+					return smt_sibling;
+				}
+				if (x.llc == y.llc) {
+					return same_llc;
+				}
+				if (x.node == y.node) {
+					return same_node;
+				}
+				return remote;
+			}
+
+			// The node the calling thread is running on right now, 0 if unknown.
+			std::size_t current_node() const noexcept {
+#ifdef __linux__
+				int cpu = sched_getcpu();
+				for (auto& info : cpus_) {
+					if (info.id == cpu) {
+						return info.node;
+					}
+				}
+#endif
+				return 0;
+			}
+
+			static bool pin_current_thread(int cpu) noexcept {
+#ifdef __linux__
+				cpu_set_t set;
+				CPU_ZERO(&set);
+				CPU_SET(cpu, &set);
+				return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+				return false;
+#endif
+			}
+
+		private:
+			void Fallback() {
+				std::size_t size = std::max(1u, std::thread::hardware_concurrency());
+				cpus_.clear();
+				for (std::size_t i = 0; i < size; i++) {
+					cpus_.push_back(cpu_info{ int(i), i, 0, 0 });
+				}
+				node_size_ = 1;
+			}
+
+#ifdef __linux__
+			void Read_sysfs() {
+				const std::string root = "/sys/devices/system/cpu/";
+				cpu_set_t allowed;
+				CPU_ZERO(&allowed);
+				bool has_mask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+				std::vector<std::size_t> node_of_cpu = Read_nodes();
+				std::vector<std::pair<long, long>> core_keys;
+				for (int cpu : Parse_cpu_list(Read_line(root + "online"))) {
+					if (has_mask && !CPU_ISSET(cpu, &allowed)) {
+						continue;
+					}
+					std::string dir = root + "cpu" + std::to_string(cpu) + "/";
+					std::pair<long, long> core_key = {
+						Read_number(dir + "topology/physical_package_id", 0),
+						Read_number(dir + "topology/core_id", cpu) };
+					auto iter = std::find(core_keys.begin(), core_keys.end(), core_key);
+					std::size_t core = iter - core_keys.begin();
+					if (iter == core_keys.end()) {
+						core_keys.push_back(core_key);
+					}
+					std::size_t node = std::size_t(cpu) < node_of_cpu.size() ? node_of_cpu[cpu] : 0;
+					cpus_.push_back(cpu_info{ cpu, core, Read_llc(dir, cpu), node });
+				}
+				Compact_nodes();
+			}
+
+			// The llc is named after the smallest cpu sharing the highest level cache with us.
+			static std::size_t Read_llc(const std::string& dir, int cpu) {
+				long best_level = -1;
+				std::size_t llc = std::size_t(cpu);
+				for (int index = 0; ; index++) {
+					std::string cache = dir + "cache/index" + std::to_string(index) + "/";
+					long level = Read_number(cache + "level", -1);
+					if (level < 0) {
+						break;
+					}
+					if (level > best_level) {
+						std::vector<int> shared = Parse_cpu_list(Read_line(cache + "shared_cpu_list"));
+						if (!shared.empty()) {
+							best_level = level;
+							llc = std::size_t(*std::min_element(shared.begin(), shared.end()));
+						}
+					}
+				}
+				return llc;
+			}
+
+			static std::vector<std::size_t> Read_nodes() {
+				const std::string root = "/sys/devices/system/node/";
+				std::vector<std::size_t> node_of_cpu;
+				for (int node : Parse_cpu_list(Read_line(root + "online"))) {
+					for (int cpu : Parse_cpu_list(Read_line(root + "node" + std::to_string(node) + "/cpulist"))) {
+						if (node_of_cpu.size() <= std::size_t(cpu)) {
+							node_of_cpu.resize(cpu + 1, 0);
+						}
+						node_of_cpu[cpu] = std::size_t(node);
+					}
+				}
+				return node_of_cpu;
+			}
+
+			// Renumbers the nodes we actually run on as 0..node_size_-1.
+			void Compact_nodes() {
+				std::vector<std::size_t> seen;
+				for (auto& info : cpus_) {
+					auto iter = std::find(seen.begin(), seen.end(), info.node);
+					std::size_t compact = iter - seen.begin();
+					if (iter == seen.end()) {
+						seen.push_back(info.node);
+					}
+					info.node = compact;
+				}
+				node_size_ = std::max<std::size_t>(1, seen.size());
+			}
+
+			static std::string Read_line(const std::string& path) {
+				std::ifstream file(path);
+				std::string line;
+				std::getline(file, line);
+				return line;
+			}
+
+			static long Read_number(const std::string& path, long fallback) {
+				std::string line = Read_line(path);
+				if (line.empty()) {
+					return fallback;
+				}
+				try {
+					return std::stol(line);
+				}
+				catch (...) {
+					return fallback;
+				}
+			}
+
+			// "0-3,8,10-11" -> { 0, 1, 2, 3, 8, 10, 11 }
+			static std::vector<int> Parse_cpu_list(const std::string& list) {
+				std::vector<int> res;
+				std::size_t pos = 0;
+				while (pos < list.size()) {
+					std::size_t comma = list.find(',', pos);
+					std::string range = list.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+					std::size_t dash = range.find('-');
+					try {
+						int first = std::stoi(range.substr(0, dash));
+						int last  = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+						for (int i = first; i <= last; i++) {
+							res.push_back(i);
+						}
+					}
+					catch (...) {}
+					if (comma == std::string::npos) {
+						break;
+					}
+					pos = comma + 1;
+				}
+				return res;
+			}
+#endif
+
+			std::vector<cpu_info> cpus_;
+			std::size_t           node_size_ = 1;
+		};
+	}
+}
+
+#endif // !COFLUX_TOPOLOGY_HPP
\ No newline at end of file
@@ -152,6 +152,22 @@ namespace coflux {
 				not_empty_cv_.notify_one();
 			}
 
+			// One lock for the whole batch, a single notify: every consumer that leaves items behind wakes the next one.
+			template <typename ForwardIt>
+			void enqueue_bulk(ForwardIt first, std::size_t count) {
+				if (count == 0) {
+					return;
+				}
+				{
+					std::lock_guard<std::mutex> lock(mtx_);
+					for (std::size_t i = 0; i < count; i++) {
+						cont_.push_back(*first++);
+					}
+					size_.fetch_add(count, std::memory_order_release);
+				}
+				not_empty_cv_.notify_one();
+			}
+
 			value_type wait_dequeue() {
 				for (int i = 0; i < constant_traits::DEQUEUE_SPIN_TIMES; i++) {
 					if (mtx_.try_lock()) {
@@ -46,6 +46,18 @@ namespace coflux {
 				queue_.enqueue(handle);
 			}
 
+			void submit_bulk(std::span<const std::coroutine_handle<>> handles) {
+				queue_.enqueue_bulk(handles.begin(), handles.size());
+			}
+
+			std::size_t size_approx() noexcept {
+				return queue_.size_approx();
+			}
+
+			bool running_in_this_thread() const noexcept {
+				return thread_.get_id() == std::this_thread::get_id();
+			}
+
 			void work() {
 				while (running_.load(std::memory_order_acquire)) {
 					std::coroutine_handle<> handle = queue_.try_dequeue();
@@ -7,6 +7,11 @@
 
 #include "../detail/forward_declaration.hpp"
 #include "ring.hpp"
+#include "parker.hpp"
+#include "topology.hpp"
+#include "adaptive_controller.hpp"
+#include "coop_budget.hpp"
+#include "timer_node.hpp"
 
 namespace coflux {
 	namespace concurrent {
@@ -14,17 +19,61 @@ namespace coflux {
 			fixed, cached
 		};
 
-		template <std::size_t N, std::size_t Align, std::size_t Idle>
+		enum class shutdown_mode {
+			drain, abort
+		};
+
+		// Snapshot of one worker's counters, see thread_pool::stats().
+		struct worker_stats {
+			bool                     active           = false;
+			std::size_t              resumed          = 0;
+			std::size_t              global_taken     = 0;	// handles moved out of the global queues
+			std::size_t              steals           = 0;
+			std::size_t              failed_steals    = 0;	// steal rounds in which every victim was empty
+			std::size_t              parks            = 0;
+			std::size_t              unparks          = 0;	// times another thread woke us up
+			std::size_t              local_high_water = 0;	// most handles seen in the local queue at once
+			std::chrono::nanoseconds idle_time{};			// spinning and parked
+			std::chrono::nanoseconds busy_time{};			// everything else since the worker started
+		};
+
+		template <typename ConstantTraits>
 		class worksteal_thread {
 		public:
+			using constant_traits = ConstantTraits;
+
+			static constexpr std::size_t N     = constant_traits::WORKSTEAL_LOCAL_QUEUE_CAPACITY;
+			static constexpr std::size_t Align = constant_traits::ALIGN_OF_LOCAL_QUEUE_HEAD_TAIL;
+
 			static_assert(  N,			  "N shoud be larger than zero");
 			static_assert(!(N & (N - 1)), "N should be power of 2.");
 
 			using value_type       = std::coroutine_handle<>;
 			using pointer          = value_type*;
-			using local_queue_type = ChaseLev_ring<value_type, N, Align>;
+			using local_queue_type = std::conditional_t<constant_traits::WORKSTEAL_LOCAL_QUEUE_GROWABLE,
+				ChaseLev_deque<value_type, N, Align>, ChaseLev_ring<value_type, N, Align>>;
+
+			using clock       = std::chrono::steady_clock;
+			using time_point  = clock::time_point;
 
-			static constexpr std::chrono::seconds max_thread_idle_time = std::chrono::seconds(Idle);
+			static constexpr std::chrono::seconds max_thread_idle_time = std::chrono::seconds(constant_traits::CACHED_MAX_IDLE_TIME_SECONDS);
+
+			static constexpr std::size_t lifo_slot_budget        = constant_traits::WORKSTEAL_LIFO_SLOT_BUDGET;
+			static constexpr std::size_t lifo_slot_private_ticks = constant_traits::WORKSTEAL_LIFO_SLOT_PRIVATE_TICKS;
+
+			static constexpr std::size_t park_spin_times         = constant_traits::WORKSTEAL_PARK_SPIN_TIMES;
+			static constexpr bool        adaptive                = constant_traits::ADAPTIVE_CONTROLLER;
+			static constexpr bool        statistics              = constant_traits::WORKSTEAL_STATISTICS;
+			static constexpr std::size_t cooperative_budget      = constant_traits::COOPERATIVE_BUDGET;
+
+			static constexpr std::size_t priority_levels         = constant_traits::PRIORITY_LEVELS;
+			static constexpr std::size_t priority_aging_interval = constant_traits::PRIORITY_AGING_INTERVAL;
+
+			static_assert(priority_levels,         "PRIORITY_LEVELS should be larger than zero.");
+			static_assert(priority_aging_interval, "PRIORITY_AGING_INTERVAL should be larger than zero.");
+
+			// Local work is drained LIFO, the global queue is polled again after this many resumes to keep it from starving.
+			static constexpr std::size_t global_queue_check_interval = 61;
 
 		public:
 			worksteal_thread()  = default;
@@ -35,7 +84,7 @@ namespace coflux {
 			worksteal_thread& operator=(const worksteal_thread&)     = delete;
 			worksteal_thread& operator=(worksteal_thread&&) noexcept = delete;
 
-			bool active() noexcept {
+			bool active() const noexcept {
 				return active_.load(std::memory_order_relaxed);
 			}
 
@@ -45,48 +94,155 @@ namespace coflux {
 				}
 			}
 
-			template <typename TaskQueue>
-			void enable(
-				TaskQueue& 										task_queue,
-				mode											run_mode,
-				std::atomic_bool& 								running,
-				std::atomic_size_t&	 					     	thread_size,
-				std::size_t										basic_thread_size,
-				std::vector<std::unique_ptr<worksteal_thread>>& threads
-			) {
-				thread_size++;
-				active_ = true;
-				thread_ = std::thread(std::bind(
-					&worksteal_thread::work<TaskQueue>,
-					this,
-					std::ref(task_queue),
-					run_mode,
-					std::ref(running),
-					std::ref(thread_size),
-					basic_thread_size,
-					std::ref(threads)
-				));
+			static worksteal_thread* current() noexcept {
+				return current_;
 			}
 
-			template <typename TaskQueue>
-			void work(
-				TaskQueue&										task_queue,
-				mode											run_mode,
-				std::atomic_bool&								running,
-				std::atomic_size_t&								thread_size,
-				std::size_t										basic_thread_size,
-				std::vector<std::unique_ptr<worksteal_thread>>& threads
-			) {
+			const void* owner() const noexcept {
+				return owner_;
+			}
+
+			// Returns the handle which can't be kept locally (nullptr if none), the caller sends it to the global queue.
+			value_type try_push_local(value_type handle) /* Only called by owner */ {
+				// A coroutine re-dispatching itself (yield, retry) would jump straight back in under LIFO order,
+				// so it goes to the global queue and lets the others run.
+				if (handle == running_) {
+					return handle;
+				}
+				if constexpr (lifo_slot_budget > 0) {
+					// The newest handle is usually the continuation we just woke up, run it next while it's hot.
+					handle = next_.exchange(handle, std::memory_order_acq_rel);
+					next_ticks_.store(0, std::memory_order_relaxed);
+					if (!handle) {
+						return nullptr;
+					}
+				}
+				if (!deque_.try_push_back(handle)) {
+					return handle;
+				}
+				Note_high_water();
+				return nullptr;
+			}
+
+			// Links a caller-owned timer node into this worker's own heap. It fires on this worker, between resumes
+			// or as the timeout of its park, so neither a timer thread nor a second handoff is involved.
+			void schedule_local(timer_node* node, time_point deadline) /* Only called by owner */ {
+				node->deadline = deadline;
+				node->timer    = this;
+				node->revoke   = &worksteal_thread::Revoke_timer;
+				timers_.push(node);
+			}
+
+			// Sleepers woken by our own timers are kept local even if others are idle, they resume where they slept.
+			bool firing_timers() const noexcept {
+				return firing_;
+			}
+
+			// Hands the timers that never fired back with fire == false, only after the owner has stopped.
+			void drop_timers() {
+				Handle_timer_cancels();
+				while (!timers_.empty()) {
+					timer_node* node = timers_.pop();
+					if (node->try_fire()) {
+						node->invoke(node, false);
+					}
+				}
+			}
+
+			// Topology mode: the cpu to pin to, our node's injection queue, and the other workers grouped by distance.
+			void place(int cpu, std::size_t home, std::vector<std::vector<std::size_t>> victim_tiers) {
+				cpu_          = cpu;
+				home_         = home;
+				victim_tiers_ = std::move(victim_tiers);
+			}
+
+			worker_stats stats() const noexcept {
+				worker_stats res;
+				res.active = active();
+				if constexpr (statistics) {
+					res.resumed          = counters_.resumed.load(std::memory_order_relaxed);
+					res.global_taken     = counters_.global_taken.load(std::memory_order_relaxed);
+					res.steals           = counters_.steals.load(std::memory_order_relaxed);
+					res.failed_steals    = counters_.failed_steals.load(std::memory_order_relaxed);
+					res.parks            = counters_.parks.load(std::memory_order_relaxed);
+					res.unparks          = counters_.unparks.load(std::memory_order_relaxed);
+					res.local_high_water = counters_.local_high_water.load(std::memory_order_relaxed);
+					res.idle_time        = std::chrono::nanoseconds(counters_.idle_ns.load(std::memory_order_relaxed));
+					auto started = counters_.started_ns.load(std::memory_order_relaxed);
+					if (started) {
+						auto alive = std::chrono::nanoseconds(Now_ns() - started);
+						res.busy_time = std::max(std::chrono::nanoseconds(0), alive - res.idle_time);
+					}
+				}
+				return res;
+			}
+
+			// Moves whatever is left in the local queue and the LIFO slot into `out`, only after the owner has stopped.
+			void drop_local(std::vector<value_type>& out) {
+				while (value_type handle = deque_.try_pop_front()) {
+					out.push_back(handle);
+				}
+				if (value_type handle = next_.exchange(nullptr, std::memory_order_acq_rel)) {
+					out.push_back(handle);
+				}
+			}
+
+			std::size_t home() const noexcept {
+				return home_;
+			}
+
+			const adaptive_sample& sample() const noexcept {
+				return sample_;
+			}
+
+			template <typename Pool>
+			void enable(Pool& pool) {
+				pool.thread_size_++;
+				active_        = true;
+				owner_         = &pool;
+				pool_running_  = &pool.running_;
+				pool_draining_ = &pool.draining_;
+				thread_ = std::thread(&worksteal_thread::work<Pool>, this, std::ref(pool));
+			}
+
+			template <typename Pool>
+			void work(Pool& pool) {
 				thread_local std::mt19937 mt(std::random_device{}());
+				auto& task_queues = pool.task_queues_;
+				auto& threads    = pool.thread_list_;
+				auto& running    = pool.running_;
+				auto& draining   = pool.draining_;
+				auto& idle_size  = pool.idle_size_;
+				mode  run_mode   = pool.mode_;
 				std::size_t n = 0;
+				current_ = this;
+				if constexpr (statistics) {
+					counters_.started_ns.store(Now_ns(), std::memory_order_relaxed);
+					counters_.idle_ns.store(0, std::memory_order_relaxed);
+				}
+				if (cpu_ >= 0) {
+					topology::pin_current_thread(cpu_);
+				}
 				while (true) {
-					if (!running.load(std::memory_order_acquire)) COFLUX_ATTRIBUTES(COFLUX_UNLIKELY) {
+					if (!running.load(std::memory_order_acquire) && !draining.load(std::memory_order_acquire)) COFLUX_ATTRIBUTES(COFLUX_UNLIKELY) {
+						current_ = nullptr;
 						return;
 					}
+					if constexpr (adaptive) {
+						pool.controller_.maybe_update(threads, task_queues);
+						batch_size_  = pool.controller_.batch_size();
+						spin_budget_ = pool.controller_.spin_budget();
+					}
+					Fire_timers();
 					// try get task from global queue
-					if (n = task_queue.try_dequeue_bulk(Receive(), N)) COFLUX_ATTRIBUTES(COFLUX_LIKELY) {
-						deque_.tail().fetch_add(n, std::memory_order_release);
-						Handle_local();
+					if (n = Refill(task_queues, home_)) COFLUX_ATTRIBUTES(COFLUX_LIKELY) {
+						// a batch is more than we can run at once, pass the wakeup on so that a sleeper comes to steal
+						if (n > 1) {
+							pool.Unpark_one(home_);
+						}
+					}
+					if (Handle_local()) {
+						continue;
 					}
 
 					// try steal from other threads
@@ -94,97 +250,519 @@ namespace coflux {
 						continue;
 					}
 
-					if (Has_work_anywhere(task_queue, threads)) COFLUX_ATTRIBUTES(COFLUX_LIKELY) {
-						std::this_thread::yield(); 
+					// other nodes' injection queues come after every local worker
+					if (task_queues.size() > priority_levels && Try_remote_queues(task_queues)) {
 						continue;
 					}
 
-					// wait for new tasks
+					// new work often shows up within a few microseconds, look around a little longer before sleeping
+					auto idle_since = Idle_begin();
+					if (Spin(task_queues, run_mode, threads, mt)) {
+						Idle_end(idle_since);
+						continue;
+					}
+
+					// a timer may have come due while we were looking around
+					if (Fire_timers()) {
+						Idle_end(idle_since);
+						continue;
+					}
+
+					// Draining and nothing left that we can see. Whatever the busy workers submit from now on
+					// is picked up by themselves before they reach this point.
+					if (!running.load(std::memory_order_seq_cst) && !Has_injected_work(task_queues)) COFLUX_ATTRIBUTES(COFLUX_UNLIKELY) {
+						// Nobody fires our timers once we are gone, so their sleepers are resumed as cancelled
+						// and we go round again to run whatever they unwind into.
+						if (Cancel_timers() || !timer_cancels_.empty()) {
+							continue;
+						}
+						current_ = nullptr;
+						return;
+					}
+
+					// Submitters read idle_size and unpark a parked worker after enqueueing to the global queue,
+					// so we register and announce parking before the last look at it to avoid a lost wakeup.
+					idle_size.fetch_add(1, std::memory_order_seq_cst);
+					parker_.prepare_park();
+					std::atomic_thread_fence(std::memory_order_seq_cst);
+					if (Has_injected_work(task_queues) || !timer_cancels_.empty() || !running.load(std::memory_order_relaxed)) {
+						parker_.cancel_park();
+						idle_size.fetch_sub(1, std::memory_order_relaxed);
+						Idle_end(idle_since);
+						continue;
+					}
+
+					// sleep until a submitter or shutdown unparks us
+					if constexpr (statistics) {
+						Count(counters_.parks);
+					}
 					switch (run_mode) {
 					case mode::fixed: {
-						n = task_queue.wait_dequeue_bulk(Receive(), N);
-						deque_.tail().fetch_add(n, std::memory_order_release);
+						// our own timers bound the sleep, the earliest one is what wakes us
+						if (timers_.empty()) {
+							parker_.park();
+						}
+						else {
+							parker_.park_for(timers_.top()->deadline - clock::now());
+						}
+						idle_size.fetch_sub(1, std::memory_order_relaxed);
 						break;
 					}
 					case mode::cached: {
-						if (!(n = task_queue.wait_dequeue_bulk_timed(Receive(), N, max_thread_idle_time))) {
-							if (!(thread_size == basic_thread_size)) {
-								Finish(thread_size);
+						bool unparked = timers_.empty()
+							? parker_.park_for(max_thread_idle_time)
+							: parker_.park_for(std::min<clock::duration>(max_thread_idle_time, timers_.top()->deadline - clock::now()));
+						idle_size.fetch_sub(1, std::memory_order_relaxed);
+						// a worker that still holds timers stays, nobody else can fire them
+						if (!unparked && timers_.empty()) {
+							if (!(pool.thread_size_ == pool.basic_thread_size_)) {
+								Finish(pool.thread_size_);
+								current_ = nullptr;
 								return;
 							}
 						}
-						else {
-							deque_.tail().fetch_add(n, std::memory_order_release);
-						}
 						break;
 					}
 					}
+					Idle_end(idle_since);
+				}
+			}
 
-					if (running.load(std::memory_order_relaxed)) COFLUX_ATTRIBUTES(COFLUX_LIKELY) {
-						if (n) COFLUX_ATTRIBUTES(COFLUX_LIKELY) {
-							// std::cerr << " THREAD" << std::this_thread::get_id() << " Handle Local\n";
-							Handle_local();
-						}
+			// Returns true if it wakes up the owner parked (or about to park).
+			bool try_unpark() noexcept {
+				if (parker_.try_unpark()) {
+					if constexpr (statistics) {
+						counters_.unparks.fetch_add(1, std::memory_order_relaxed);
 					}
-
+					return true;
 				}
+				return false;
 			}
 
 		private:
+			// The global queue writes straight behind our tail, thieves can't see these slots until tail is published.
 			auto Receive() const noexcept {
-				return deque_.begin();
+				return deque_.end();
 			}
 
-			template <typename TaskQueue>
-			bool Has_work_anywhere(TaskQueue& task_queue, std::vector<std::unique_ptr<worksteal_thread>>& threads) noexcept {
-				if (task_queue.size_approx()) {
-					return true;
+			std::size_t Vacancy() {
+				if constexpr (constant_traits::WORKSTEAL_LOCAL_QUEUE_GROWABLE) {
+					deque_.reserve_back(N);
+				}
+				std::size_t vacancy = std::min(N, deque_.capacity() - deque_.size_approx());
+				if constexpr (adaptive) {
+					vacancy = std::min(vacancy, batch_size_);
 				}
-				for (auto& t : threads) {
-					if (t->deque_.size_approx() > 0) { 
+				return vacancy;
+			}
+
+			template <typename TaskQueues>
+			bool Spin(TaskQueues& task_queues, mode run_mode, std::vector<std::unique_ptr<worksteal_thread>>& threads, std::mt19937& mt) noexcept {
+				std::size_t spin_times = adaptive ? spin_budget_ : park_spin_times;
+				if constexpr (adaptive) {
+					adaptive_sample::add(sample_.spins);
+				}
+				for (std::size_t i = 0; i < spin_times; i++) {
+					if (Has_injected_work(task_queues) || Try_steal(run_mode, threads, mt)) {
+						if constexpr (adaptive) {
+							adaptive_sample::add(sample_.spin_hits);
+						}
+						return true;
+					}
+					std::this_thread::yield();
+				}
+				return false;
+			}
+
+			template <typename TaskQueues>
+			static bool Has_injected_work(TaskQueues& task_queues) noexcept {
+				for (auto& queue : task_queues) {
+					if (queue->size_approx()) {
+						return true;
+					}
+				}
+				return false;
+			}
+
+			template <typename TaskQueues>
+			bool Try_remote_queues(TaskQueues& task_queues) {
+				std::size_t nodes = task_queues.size() / priority_levels;
+				for (std::size_t i = 1; i < nodes; i++) {
+					if (Refill(task_queues, (home_ + i) % nodes)) {
+						Handle_local();
 						return true;
 					}
 				}
 				return false;
 			}
 
+			// Moves handles from one node's injection queues behind our tail, returns how many.
+			// The queues are laid out level by level (0 is the highest priority), one per node in each level.
+			// The highest level comes in bulk, lower levels one at a time so that new urgent work waits
+			// behind at most one of them. Every `priority_aging_interval` refills a lower level goes first.
+			template <typename TaskQueues>
+			std::size_t Refill(TaskQueues& task_queues, std::size_t node) {
+				std::size_t nodes   = task_queues.size() / priority_levels;
+				std::size_t vacancy = Vacancy();
+				std::size_t n       = 0;
+				if (!vacancy) {
+					return 0;
+				}
+				if constexpr (priority_levels > 1) {
+					if (++refill_rounds_ % priority_aging_interval == 0) {
+						std::size_t first = refill_rounds_ / priority_aging_interval;
+						for (std::size_t i = 0; i < priority_levels - 1; i++) {
+							std::size_t level = 1 + (first + i) % (priority_levels - 1);
+							if (n = Take(*task_queues[level * nodes + node], 1)) {
+								return n;
+							}
+						}
+					}
+				}
+				if (n = Take(*task_queues[node], vacancy)) {
+					return n;
+				}
+				for (std::size_t level = 1; level < priority_levels; level++) {
+					if (n = Take(*task_queues[level * nodes + node], 1)) {
+						return n;
+					}
+				}
+				return 0;
+			}
+
+			template <typename TaskQueue>
+			std::size_t Take(TaskQueue& task_queue, std::size_t count) {
+				std::size_t n = task_queue.try_dequeue_bulk(Receive(), count);
+				if (n) {
+					deque_.tail().fetch_add(n, std::memory_order_release);
+					if constexpr (statistics) {
+						Count(counters_.global_taken, n);
+						Note_high_water();
+					}
+					if constexpr (adaptive) {
+						adaptive_sample::add(sample_.refills);
+						adaptive_sample::add(sample_.refilled, n);
+						adaptive_sample::add(sample_.refill_capacity, count);
+					}
+				}
+				return n;
+			}
+
+			// Returns true if any timer fired or was given back cancelled. Either resubmits the sleeper through the pool,
+			// which keeps it local.
+			bool Fire_timers() {
+				if (timers_.empty() && timer_cancels_.empty()) {
+					return false;
+				}
+				firing_ = true;
+				bool fired = Handle_timer_cancels();
+				time_point now = clock::now();
+				while (!timers_.empty() && timers_.top()->deadline <= now) {
+					timer_node* node = timers_.pop();
+					// a cancelled node is already on its way back through timer_cancels_
+					if (node->try_fire()) {
+						node->invoke(node, true);
+						fired = true;
+					}
+				}
+				firing_ = false;
+				return fired;
+			}
+
+			// Draining: every sleep still waiting in our heap ends with cancel_exception instead of outliving the pool.
+			// A node someone else has just cancelled is left to timer_cancels_, which the caller keeps an eye on.
+			bool Cancel_timers() {
+				bool cancelled = Handle_timer_cancels();
+				while (!timers_.empty()) {
+					timer_node* node = timers_.pop();
+					int expected = timer_node::armed;
+					if (node->st.compare_exchange_strong(expected, timer_node::cancelled, std::memory_order_acq_rel, std::memory_order_acquire)) {
+						node->invoke(node, false);
+						cancelled = true;
+					}
+				}
+				return cancelled;
+			}
+
+			// Any thread may cancel one of our timers, the node is pushed here and we unlink it ourselves.
+			static void Revoke_timer(void* self, timer_node* node) noexcept {
+				auto* worker = static_cast<worksteal_thread*>(self);
+				worker->timer_cancels_.push(node);
+				worker->try_unpark();
+			}
+
+			bool Handle_timer_cancels() {
+				timer_node* node = timer_cancels_.take();
+				bool handled = node != nullptr;
+				while (node) {
+					timer_node* next = node->cancel_next;
+					if (node->index != timer_node::unlinked) {
+						timers_.erase(node);
+					}
+					node->invoke(node, false);
+					node = next;
+				}
+				return handled;
+			}
+
+			bool Has_local_work() const noexcept {
+				if constexpr (lifo_slot_budget > 0) {
+					if (next_.load(std::memory_order_relaxed)) {
+						return true;
+					}
+				}
+				return deque_.size_approx() > 0;
+			}
+
 			void Finish(std::atomic<std::size_t>& thread_size) noexcept {
 				thread_size--;
 				active_ = false;
 			}
 			
-			void Handle_local() noexcept {
-				value_type handle = nullptr;
-				while (handle = deque_.try_pop_back()) {
-					handle.resume();
+			// Each round starts with the oldest local handle, then keeps LIFO order for locality.
+			// Returns true if we stop with local work left, so that the global queue gets a look in.
+			// An abort is noticed between two resumes, what we haven't taken yet stays local for drop_local.
+			bool Handle_local() noexcept {
+				for (std::size_t i = 0; i < global_queue_check_interval; i++) {
+					if (Aborting()) COFLUX_ATTRIBUTES(COFLUX_UNLIKELY) {
+						return true;
+					}
+					value_type handle = i == 0 ? deque_.try_pop_front() : nullptr;
+					if (!handle && !(handle = Pop_local())) {
+						return false;
+					}
+					Resume(handle);
+				}
+				return Has_local_work();
+			}
+
+			bool Aborting() const noexcept {
+				return !pool_running_->load(std::memory_order_acquire) && !pool_draining_->load(std::memory_order_acquire);
+			}
+
+			// The LIFO slot goes first, but the deque gets a turn after every `lifo_slot_budget` slot resumes,
+			// so that two coroutines handing off to each other can't starve it.
+			value_type Pop_local() noexcept {
+				if constexpr (lifo_slot_budget > 0) {
+					if (lifo_streak_ < lifo_slot_budget) {
+						if (next_.load(std::memory_order_relaxed)) {
+							if (value_type handle = next_.exchange(nullptr, std::memory_order_acq_rel)) {
+								lifo_streak_++;
+								return handle;
+							}
+						}
+					}
+					lifo_streak_ = 0;
+					if (value_type handle = deque_.try_pop_back()) {
+						return handle;
+					}
+					return next_.exchange(nullptr, std::memory_order_acq_rel);
+				}
+				else {
+					return deque_.try_pop_back();
 				}
 			}
 
+			void Resume(value_type handle) noexcept {
+				if constexpr (statistics) {
+					Count(counters_.resumed);
+				}
+				if constexpr (cooperative_budget) {
+					coop_budget::reset(cooperative_budget);
+				}
+				running_ = handle;
+				handle.resume();
+				running_ = nullptr;
+			}
+
+			// Victims are probed from a random position, the first one with work hands over up to half of it
+			// and we drain that locally before looking at the global queue again.
+			// In topology mode the nearest tier (SMT siblings, then same llc, same node, remote) is exhausted first.
 			bool Try_steal(mode run_mode, std::vector<std::unique_ptr<worksteal_thread>>& threads, std::mt19937& mt) noexcept {
+				if constexpr (adaptive) {
+					adaptive_sample::add(sample_.steal_tries);
+				}
+				if (Try_steal_round(run_mode, threads, mt)) {
+					return true;
+				}
+				if constexpr (statistics) {
+					Count(counters_.failed_steals);
+				}
+				return false;
+			}
+
+			bool Try_steal_round(mode run_mode, std::vector<std::unique_ptr<worksteal_thread>>& threads, std::mt19937& mt) noexcept {
+				if (!victim_tiers_.empty()) {
+					for (auto& tier : victim_tiers_) {
+						if (Try_steal_from(run_mode, threads, tier, mt)) {
+							return true;
+						}
+					}
+					return false;
+				}
 				std::size_t threads_size = threads.size();
 				std::size_t begin_pos = (std::size_t)mt() & (threads_size - 1);
-				bool stolen = false;
 				for (int i = 0; i < threads_size; i++) {
 					size_t idx = (i + begin_pos) & (threads_size - 1);
 					if (threads[idx].get() == this || (run_mode == mode::cached ? !threads[idx]->active() : false)) {
 						continue;
 					}
-					value_type handle = threads[idx]->Steal();
-					if (handle) {
-						handle.resume();
-						stolen = true;
+					if (Try_steal_from(*threads[idx])) {
+						return true;
+					}
+				}
+				return false;
+			}
+
+			bool Try_steal_from(mode run_mode, std::vector<std::unique_ptr<worksteal_thread>>& threads,
+				const std::vector<std::size_t>& tier, std::mt19937& mt) noexcept {
+				std::size_t begin_pos = (std::size_t)mt() % tier.size();
+				for (std::size_t i = 0; i < tier.size(); i++) {
+					worksteal_thread& victim = *threads[tier[(i + begin_pos) % tier.size()]];
+					if (run_mode == mode::cached && !victim.active()) {
+						continue;
+					}
+					if (Try_steal_from(victim)) {
+						return true;
 					}
 				}
-				return stolen;
+				return false;
+			}
+
+			bool Try_steal_from(worksteal_thread& victim) noexcept {
+				if (value_type handle = Steal_half(victim)) {
+					if constexpr (adaptive) {
+						adaptive_sample::add(sample_.steals);
+					}
+					if constexpr (statistics) {
+						Count(counters_.steals);
+						Note_high_water();
+					}
+					Resume(handle);
+					Handle_local();
+					return true;
+				}
+				return false;
+			}
+
+			// Moves up to half of the victim's local queue into ours, returns the oldest stolen handle to run first.
+			value_type Steal_half(worksteal_thread& victim) noexcept {
+				value_type first = victim.Steal();
+				if (!first) {
+					return nullptr;
+				}
+				std::size_t batch = std::min((victim.deque_.size_approx() + 1) / 2, Free_local());
+				for (std::size_t i = 0; i < batch; i++) {
+					value_type handle = victim.deque_.try_pop_front();
+					if (!handle) {
+						break;
+					}
+					// Free_local() was taken by the owner and thieves only shrink the queue, so this never fails.
+					COFLUX_ATTRIBUTES(COFLUX_MAYBE_UNUSED) bool pushed = deque_.try_push_back(handle);
+					assert(pushed);
+				}
+				return first;
+			}
+
+			// Free slots in the local queue without growing it, stealing never allocates.
+			std::size_t Free_local() const noexcept {
+				return deque_.capacity() - deque_.size_approx();
+			}
+
+			static void Count(std::atomic_size_t& counter, std::size_t n = 1) noexcept {
+				counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+			}
+
+			void Note_high_water() noexcept {
+				if constexpr (statistics) {
+					std::size_t size = deque_.size_approx();
+					if (size > counters_.local_high_water.load(std::memory_order_relaxed)) {
+						counters_.local_high_water.store(size, std::memory_order_relaxed);
+					}
+				}
+			}
+
+			static std::int64_t Now_ns() noexcept {
+				return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+			}
+
+			std::int64_t Idle_begin() const noexcept {
+				if constexpr (statistics) {
+					return Now_ns();
+				}
+				else {
+					return 0;
+				}
+			}
+
+			void Idle_end(std::int64_t since) noexcept {
+				if constexpr (statistics) {
+					counters_.idle_ns.store(counters_.idle_ns.load(std::memory_order_relaxed) + (Now_ns() - since), std::memory_order_relaxed);
+				}
 			}
 
 			value_type Steal() noexcept {
-				return deque_.try_pop_front();
+				if (value_type handle = deque_.try_pop_front()) {
+					return handle;
+				}
+				if constexpr (lifo_slot_budget > 0) {
+					// The slot is private while its owner keeps going. It is only taken after thieves have found it
+					// occupied `lifo_slot_private_ticks` times in a row, e.g. the owner is blocked in a long resume.
+					if (next_.load(std::memory_order_relaxed)) {
+						if (next_ticks_.fetch_add(1, std::memory_order_relaxed) >= lifo_slot_private_ticks) {
+							return next_.exchange(nullptr, std::memory_order_acq_rel);
+						}
+					}
+				}
+				return nullptr;
 			}
 
+			// Written by the owner only (unparks aside), on lines of their own so the hot fields above stay quiet.
+			struct counters {
+				alignas(Align) std::atomic_size_t resumed          = 0;
+				std::atomic_size_t                global_taken     = 0;
+				std::atomic_size_t                steals           = 0;
+				std::atomic_size_t                failed_steals    = 0;
+				std::atomic_size_t                parks            = 0;
+				std::atomic_size_t                local_high_water = 0;
+				std::atomic<std::int64_t>         idle_ns          = 0;
+				std::atomic<std::int64_t>         started_ns       = 0;
+				alignas(Align) std::atomic_size_t unparks          = 0;
+			};
+			struct no_counters {};
+
+			static inline thread_local worksteal_thread* current_ = nullptr;
+
 			std::atomic_bool active_ = false;
 			std::thread      thread_;
+			const void*      owner_   = nullptr;
+			value_type       running_ = nullptr;
 			local_queue_type deque_;
+			parker           parker_;
+
+			// the owner's flags, read between resumes to notice an abort
+			const std::atomic_bool* pool_running_  = nullptr;
+			const std::atomic_bool* pool_draining_ = nullptr;
+
+			int                                   cpu_  = -1;
+			std::size_t                           home_ = 0;
+			std::vector<std::vector<std::size_t>> victim_tiers_;
+			std::size_t                           refill_rounds_ = 0;
+
+			// Knobs copied from the pool's adaptive_controller once per round, and what we feed back to it.
+			std::size_t     batch_size_  = N;
+			std::size_t     spin_budget_ = park_spin_times;
+			adaptive_sample sample_;
+
+			COFLUX_ATTRIBUTES(COFLUX_NO_UNIQUE_ADDRESS) std::conditional_t<statistics, counters, no_counters> counters_;
+
+			timer_heap              timers_;
+			timer_cancel_inbox      timer_cancels_;
+			bool                    firing_ = false;
+
+			std::atomic<value_type> next_         { nullptr };
+			std::atomic_size_t      next_ticks_   = 0;
+			std::size_t             lifo_streak_  = 0;
 		};
 	}
 }
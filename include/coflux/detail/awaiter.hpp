@@ -7,6 +7,7 @@
 
 #include "forward_declaration.hpp"
 #include "../scheduler.hpp"
+#include "../concurrent/coop_budget.hpp"
 
 namespace coflux {
     namespace detail {
@@ -57,8 +58,11 @@ namespace coflux {
             bool await_ready() const noexcept { return false; }
 
             template <typename Promise>
-            void await_suspend(std::coroutine_handle<Promise> handle) const noexcept {
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept {
+                // Read before counting down, the frame may be destroyed by a joiner right after.
+                std::coroutine_handle<> continuation = handle.promise().take_continuation();
                 handle.promise().final_latch_count_down();
+                return continuation ? continuation : std::noop_coroutine();
             }
 
             void await_resume() const noexcept {}
@@ -104,17 +108,30 @@ namespace coflux {
             awaiter& operator=(awaiter&&)      = default;
 
             bool await_ready() const noexcept {
-                return task_.done();
+                return task_.done() && concurrent::coop_budget::consume();
             }
 
             template <typename Promise>
             bool await_suspend(std::coroutine_handle<Promise> handle) {
                 if (task_.done()) COFLUX_ATTRIBUTES(COFLUX_UNLIKELY) {
-                    return false;
+                    if (!concurrent::coop_budget::exhausted()) {
+                        return false;
+                    }
+                    // Out of budget: the result is there, we only give the worker back.
+                    suspend_base::await_suspend();
+                    suspend_base::execute(handle);
+                    return true;
                 }
                 suspend_base::await_suspend();
                 std::atomic_signal_fence(std::memory_order_acquire);
                 task_.then([this, handle]() {
+                    // Already on one of our executor's threads: let the child transfer to us when it finishes.
+                    if constexpr (requires { task_.try_set_continuation(handle); }) {
+                        if (suspend_base::executor_traits::running_in_this_thread(this->executor_)
+                            && task_.try_set_continuation(handle)) {
+                            return;
+                        }
+                    }
                     suspend_base::execute(handle);
                     });
                 return true;
@@ -141,6 +158,12 @@ namespace coflux {
         template <executive Executor>
         struct sleep_awaiter;
 
+        template <bool Ownership, executive Executor>
+        struct interval_timer;
+
+        template <bool Ownership, executive Executor>
+        struct interval_awaiter;
+
         template <bool Ownership>
         struct get_stop_token_awaiter;
 
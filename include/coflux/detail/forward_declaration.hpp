@@ -18,6 +18,7 @@
 #include <concepts>
 #include <coroutine>
 #include <exception>
+#include <cassert>
 #include <type_traits>
 #include <functional>
 #include <tuple>
@@ -48,6 +49,7 @@
 #include <latch>
 #include <stop_token>
 #include <source_location>
+#include <span>
 
 #define COFLUX_EXPERIMENTAL		  0
 #define COFLUX_UNDER_CONSTRUCTION 0
@@ -157,6 +159,18 @@ namespace coflux {
 	template <typename Executor>
 	concept executive = (!std::is_reference_v<Executor>) && (executive_handle<Executor> || executive_function<Executor>);
 
+	// Optional: takes a whole batch at once, executor_traits falls back to one execute per handle.
+	template <typename Executor>
+	concept executive_bulk = executive<Executor> && requires(Executor executor, std::span<const std::coroutine_handle<>> handles) {
+		executor.execute_bulk(handles);
+	};
+
+	// Optional: tells whether the calling thread is one of its own, so a continuation may run here without a round trip.
+	template <typename Executor>
+	concept executive_affine = executive<Executor> && requires(const Executor executor) {
+		{ executor.running_in_this_thread() } -> std::convertible_to<bool>;
+	};
+
 	template <executive Executor, std::size_t N>
 	struct index : std::integral_constant<std::size_t, N> {
 		using type = Executor;
@@ -390,7 +404,7 @@ namespace coflux {
 		template <typename Ty>
 		struct promise_yield_base;
 
-		template <typename Ty, simple_awaitable Initial, simple_awaitable Final, bool TaskLikePromise, bool Ownership>
+		template <typename Ty, simple_awaitable Initial, awaitable Final, bool TaskLikePromise, bool Ownership>
 		struct promise_base;
 
 		template <typename Ty>
@@ -7,6 +7,7 @@
 
 #include "result.hpp"
 #include "../channel.hpp"
+#include "../concurrent/deadline_registry.hpp"
 
 namespace coflux {
 	namespace detail {
@@ -25,6 +26,7 @@ namespace coflux {
 			using handle_type				= std::coroutine_handle<promise_fork_base<false>>;
 			using brother_handle			= std::conditional_t<Ownership, std::monostate, handle_type>;
 			using cancellaton_callback_type = std::optional<std::stop_callback<std::function<void()>>>;
+			using deadline_type             = concurrent::deadline_registry::time_point;
 
 			promise_fork_base() {
 #if COFLUX_DEBUG
@@ -36,6 +38,9 @@ namespace coflux {
 			}
 			virtual ~promise_fork_base() {
 				destroy_forks();
+				if (deadline_ != concurrent::deadline_registry::none) {
+					concurrent::deadline_registry::instance().erase(std::coroutine_handle<promise_fork_base>::from_promise(*this).address());
+				}
 			}
 
 			void join_forks() {
@@ -64,6 +69,15 @@ namespace coflux {
 				);
 				child_promise.brothers_next_ = children_head_;
 				children_head_ = new_children;
+				if (deadline_ != concurrent::deadline_registry::none) {
+					child_promise.set_deadline(deadline_);
+				}
+			}
+
+			// Published for executors which order by deadline, inherited by forks created afterwards.
+			void set_deadline(deadline_type deadline) {
+				deadline_ = deadline;
+				concurrent::deadline_registry::instance().set(std::coroutine_handle<promise_fork_base>::from_promise(*this).address(), deadline);
 			}
 
 			void destroy_forks() noexcept {
@@ -89,9 +103,48 @@ namespace coflux {
 				final_latch_.count_down();
 			}
 
-			std::latch       final_latch_{ 1 };
-			std::stop_source stop_source_;
-			handle_type      children_head_ = nullptr;
+			// Only succeeds from inside this promise's own completion callbacks: the waiter is then resumed
+			// by final_awaiter through symmetric transfer instead of a trip through its executor.
+			bool try_set_continuation(std::coroutine_handle<> waiter) noexcept {
+				if (completing_ != this || continuation_) {
+					return false;
+				}
+				continuation_ = waiter;
+				return true;
+			}
+
+			std::coroutine_handle<> take_continuation() noexcept {
+				return std::exchange(continuation_, nullptr);
+			}
+
+			// A cancelled sleep unwinds the body with cancel_exception, which ends the task as cancelled, not failed.
+			template <typename Result>
+			static void store_current_exception(Result& result) noexcept {
+				try {
+					throw;
+				}
+				catch (const cancel_exception&) {
+					result.emplace_cancel();
+				}
+				catch (...) {
+					result.emplace_error(std::current_exception());
+				}
+			}
+
+			struct completion_scope {
+				explicit completion_scope(promise_fork_base* p) noexcept : previous_(std::exchange(completing_, p)) {}
+				~completion_scope() { completing_ = previous_; }
+
+				promise_fork_base* previous_;
+			};
+
+			std::latch              final_latch_{ 1 };
+			std::stop_source        stop_source_;
+			handle_type             children_head_ = nullptr;
+			deadline_type           deadline_      = concurrent::deadline_registry::none;
+			std::coroutine_handle<> continuation_  = nullptr;
+
+			inline static thread_local promise_fork_base* completing_ = nullptr;
 
 			COFLUX_ATTRIBUTES(COFLUX_NO_UNIQUE_ADDRESS) brother_handle	brothers_next_ {};
 
@@ -121,7 +174,7 @@ namespace coflux {
 			~promise_result_base() override = default;
 
 			void unhandled_exception() noexcept {
-				result_.emplace_error(std::current_exception());
+				this->store_current_exception(result_);
 				std::atomic_signal_fence(std::memory_order_seq_cst);
 				invoke_callbacks();
 			}
@@ -229,6 +282,7 @@ namespace coflux {
 					std::lock_guard<std::mutex> guard(this->mtx_);
 					cbs.swap(callbacks_);
 				}
+				typename fork_base::completion_scope scope(this);
 				for (auto& cb : cbs) {
 					cb(this->result_);
 				}
@@ -252,7 +306,7 @@ namespace coflux {
 			~promise_result_base() override = default;
 
 			void unhandled_exception() noexcept {
-				result_.emplace_error(std::current_exception());
+				this->store_current_exception(result_);
 				std::atomic_signal_fence(std::memory_order_seq_cst);
 				invoke_callbacks();
 			}
@@ -355,6 +409,7 @@ namespace coflux {
 					std::lock_guard<std::mutex> guard(this->mtx_);
 					cbs.swap(callbacks_);
 				}
+				typename fork_base::completion_scope scope(this);
 				for (auto& cb : cbs) {
 					cb(this->result_);
 				}
@@ -399,10 +454,10 @@ namespace coflux {
 			yield_proxy product_;
 		};
 
-		template <typename Ty, simple_awaitable Initial, simple_awaitable Final, bool TaskLikePromise, bool Ownership>
+		template <typename Ty, simple_awaitable Initial, awaitable Final, bool TaskLikePromise, bool Ownership>
 		struct promise_base;
 
-		template <typename Ty, simple_awaitable Initial, simple_awaitable Final, bool Ownership>
+		template <typename Ty, simple_awaitable Initial, awaitable Final, bool Ownership>
 		struct promise_base<Ty, Initial, Final, true, Ownership>
 			: public promise_result_base<Ty, Ownership> {
 			using result_base  = promise_result_base<Ty, Ownership>;
@@ -419,7 +474,7 @@ namespace coflux {
 			constexpr Final   final_suspend()   const noexcept { return {}; }
 		};
 
-		template <typename Ty, simple_awaitable Initial, simple_awaitable Final>
+		template <typename Ty, simple_awaitable Initial, awaitable Final>
 		struct promise_base<Ty, Initial, Final, false, false> : public promise_yield_base<Ty> {
 			using yield_base  = promise_yield_base<Ty>;
 			using value_type  = typename yield_base::value_type;
@@ -433,7 +488,7 @@ namespace coflux {
 		struct promise;
 
 		template <typename Ty, executive_or_certain_executor Executor, schedulable Scheduler,
-			simple_awaitable Initial, simple_awaitable Final, bool Ownership>
+			simple_awaitable Initial, awaitable Final, bool Ownership>
 		struct promise<basic_task<Ty, Executor, Scheduler, Initial, Final, Ownership>> final
 			: public promise_base<Ty, Initial, Final, true, Ownership> {
 			using base             = promise_base<Ty, Initial, Final, true, Ownership>;
@@ -573,12 +628,28 @@ namespace coflux {
 			template <typename Rep, typename Period>
 			auto await_transform(const std::chrono::duration<Rep, Period>& sleep_time) noexcept {
 				return sleep_awaiter<Executor>(/* Capture executor in awaite_suspend */
-					std::chrono::duration_cast<std::chrono::milliseconds>(sleep_time), &(this->get_status()));
+					std::chrono::steady_clock::now() + std::chrono::ceil<std::chrono::steady_clock::duration>(sleep_time), &(this->get_status()));
 			}
 
 			template <typename Rep, typename Period>
 			auto await_transform(const sleep_t<Ownership, Rep, Period>& sleep_request) noexcept {
-				return await_transform<Rep, Period>(sleep_request.dur_);
+				return sleep_awaiter<Executor>(concurrent::coalesce(
+					std::chrono::steady_clock::now() + std::chrono::ceil<std::chrono::steady_clock::duration>(sleep_request.dur_),
+					sleep_request.slack_), &(this->get_status()));
+			}
+
+			template <typename Duration>
+			auto await_transform(const sleep_until_t<Ownership, Duration>& sleep_request) noexcept {
+				return sleep_awaiter<Executor>(concurrent::coalesce(
+					std::chrono::ceil<std::chrono::steady_clock::duration>(sleep_request.deadline_),
+					sleep_request.slack_), &(this->get_status()));
+			}
+
+			template <typename Rep, typename Period>
+			auto await_transform(const interval_t<Ownership, Rep, Period>& interval_request) noexcept {
+				return get_interval_awaiter<Ownership, Executor>(
+					std::chrono::ceil<std::chrono::steady_clock::duration>(interval_request.period_), &(this->get_status()),
+					this->stop_source_.get_token());
 			}
 
 			auto await_transform(yield_t<Ownership> yield_request) noexcept {
@@ -7,7 +7,11 @@
 
 #include "concurrent/thread_pool.hpp"
 #include "concurrent/timer_thread.hpp"
+#include "concurrent/timing_wheel.hpp"
 #include "concurrent/worker_thread.hpp"
+#include "concurrent/edf_pool.hpp"
+#include "concurrent/shard_group.hpp"
+#include "concurrent/blocking_pool.hpp"
 
 namespace coflux {
 	class noop_executor {
@@ -24,6 +28,10 @@ namespace coflux {
 			handle.resume();
 		}
 
+		bool running_in_this_thread() const noexcept {
+			return true;
+		}
+
 		template <typename Func, typename... Args>
 		void execute(Func&& func, Args&&... args) {
 			func(std::forward<Args>(args)...);
@@ -72,7 +80,7 @@ namespace coflux {
 	
 	// template <typename TaskQueue = moodycamel::BlockingConcurrentQueue<std::coroutine_handle<>>, typename Contants = default_thread_pool_constants>
 	// coflux support moodycamel::BlockingConcurrentQueue as template argument of thread_pool, but we don't provide it directly.
-	template <typename TaskQueue = concurrent::unbounded_queue<>, typename Contants = concurrent::default_thread_pool_constants>
+	template <typename TaskQueue = concurrent::segmented_queue<>, typename Contants = concurrent::default_thread_pool_constants>
 	class thread_pool_executor {
 	public:
 		using thread_pool = concurrent::thread_pool<TaskQueue, Contants>;
@@ -98,6 +106,19 @@ namespace coflux {
 			pool_->submit(handle);
 		}
 
+		void execute_bulk(std::span<const std::coroutine_handle<>> handles) {
+			pool_->submit_bulk(handles);
+		}
+
+		bool running_in_this_thread() const noexcept {
+			return pool_->running_in_this_thread();
+		}
+
+		// Sleeps issued on a worker stay on it, see worksteal_thread::schedule_local.
+		bool try_schedule_local(concurrent::timer_node* node, std::chrono::steady_clock::time_point deadline) {
+			return pool_->try_schedule_local(node, deadline);
+		}
+
 		thread_pool& get_thread_pool() {
 			return *pool_;
 		}
@@ -106,16 +127,217 @@ namespace coflux {
 		std::shared_ptr<thread_pool> pool_;
 	};
 
+	namespace detail {
+		template <std::size_t Levels, typename Constants>
+		struct priority_constants : Constants {
+			static constexpr std::size_t PRIORITY_LEVELS = Levels;
+		};
+
+		template <typename Group>
+		class priority_level_base {
+		public:
+			using owner_group = Group;
+			using thread_pool = typename Group::thread_pool;
+
+		public:
+			priority_level_base() = default;
+			priority_level_base(std::shared_ptr<thread_pool> pool, std::size_t level)
+				: pool_(std::move(pool)), level_(level) {}
+			~priority_level_base() = default;
+
+			priority_level_base(const priority_level_base&)            = default;
+			priority_level_base(priority_level_base&&)                 = default;
+			priority_level_base& operator=(const priority_level_base&) = default;
+			priority_level_base& operator=(priority_level_base&&)      = default;
+
+			void execute(std::coroutine_handle<> handle) {
+				pool_->submit(handle, level_);
+			}
+
+			void execute_bulk(std::span<const std::coroutine_handle<>> handles) {
+				pool_->submit_bulk(handles, level_);
+			}
+
+		private:
+			std::shared_ptr<thread_pool> pool_;
+			std::size_t                  level_ = 0;
+		};
+
+		template <std::size_t L, typename Group>
+		class priority_level : public priority_level_base<Group> {
+		public:
+			using base        = priority_level_base<Group>;
+			using owner_group = typename base::owner_group;
+
+			static constexpr std::size_t pos = L;
+
+		public:
+			priority_level()  = default;
+			~priority_level() = default;
+
+			priority_level(const priority_level&)            = default;
+			priority_level(priority_level&&)                 = default;
+			priority_level& operator=(const priority_level&) = default;
+			priority_level& operator=(priority_level&&)      = default;
+
+			void execute(std::coroutine_handle<> handle) {
+				base::execute(handle);
+			}
+		};
+	}
+
+	// One thread_pool with `Levels` run levels, level<0> is the most urgent.
+	// Tasks pick a level by type, e.g. task<T, priority_thread_pool_executor<3>::level<0>, scheduler<priority_thread_pool_executor<3>>>,
+	// the executor itself submits at the lowest level.
+	template <std::size_t Levels, typename TaskQueue = concurrent::segmented_queue<>, typename Contants = concurrent::default_thread_pool_constants>
+	class priority_thread_pool_executor {
+	public:
+		static_assert(Levels, "Levels shoud be larger than zero");
+
+		using thread_pool = concurrent::thread_pool<TaskQueue, detail::priority_constants<Levels, Contants>>;
+		using queue_type  = typename thread_pool::queue_type;
+
+		template <std::size_t L>
+		using level       = detail::priority_level<L, priority_thread_pool_executor>;
+		using level_array = std::array<detail::priority_level_base<priority_thread_pool_executor>, Levels>;
+
+	public:
+		template <typename...Args>
+		priority_thread_pool_executor(
+			std::size_t      basic_thread_size	   = std::thread::hardware_concurrency(),
+			concurrent::mode run_mode			   = concurrent::mode::fixed,
+			std::size_t      thread_size_threshold = std::thread::hardware_concurrency() * 2,
+			Args&&...        args)
+			: pool_(std::make_shared<thread_pool>(
+				basic_thread_size, run_mode, thread_size_threshold, std::forward<Args>(args)...)) {
+			for (std::size_t i = 0; i < Levels; i++) {
+				levels_[i] = detail::priority_level_base<priority_thread_pool_executor>(pool_, i);
+			}
+		}
+		~priority_thread_pool_executor() = default;
+
+		priority_thread_pool_executor(const priority_thread_pool_executor&)			   = default;
+		priority_thread_pool_executor(priority_thread_pool_executor&&)			       = default;
+		priority_thread_pool_executor& operator=(const priority_thread_pool_executor&) = default;
+		priority_thread_pool_executor& operator=(priority_thread_pool_executor&&)      = default;
+
+		void execute(std::coroutine_handle<> handle) {
+			pool_->submit(handle, Levels - 1);
+		}
+
+		void execute_bulk(std::span<const std::coroutine_handle<>> handles) {
+			pool_->submit_bulk(handles, Levels - 1);
+		}
+
+		template <std::size_t L>
+		auto& get() noexcept {
+			static_assert(L < Levels, "level out of range.");
+			return *static_cast<level<L>*>(&levels_[L]);
+		}
+
+		thread_pool& get_thread_pool() {
+			return *pool_;
+		}
+
+	private:
+		std::shared_ptr<thread_pool> pool_;
+		level_array                  levels_;
+	};
+
+	template <std::size_t L, typename Group, std::size_t N>
+	struct index<detail::priority_level<L, Group>, N> : std::integral_constant<std::size_t, N> {
+		using type        = Group;
+		using owner_group = Group;
+
+		static constexpr std::size_t pos = L;
+	};
+
+	// Runs the handle with the earliest deadline first, see this_task::set_deadline.
+	class edf_executor {
+	public:
+		using edf_pool   = concurrent::edf_pool;
+		using clock      = typename edf_pool::clock;
+		using time_point = typename edf_pool::time_point;
+
+	public:
+		explicit edf_executor(std::size_t thread_size = std::thread::hardware_concurrency())
+			: pool_(std::make_shared<edf_pool>(thread_size)) {}
+		~edf_executor() = default;
+
+		edf_executor(const edf_executor&)            = default;
+		edf_executor(edf_executor&&)                 = default;
+		edf_executor& operator=(const edf_executor&) = default;
+		edf_executor& operator=(edf_executor&&)      = default;
+
+		void execute(std::coroutine_handle<> handle) {
+			pool_->submit(handle);
+		}
+
+		void execute_bulk(std::span<const std::coroutine_handle<>> handles) {
+			pool_->submit_bulk(handles);
+		}
+
+		edf_pool& get_edf_pool() {
+			return *pool_;
+		}
+
+	private:
+		std::shared_ptr<edf_pool> pool_;
+	};
+
+	// For coroutines about to block: co_await this_task::dispatch(blocking) before the call, dispatch back after it.
+	class blocking_executor {
+	public:
+		using blocking_pool = concurrent::blocking_pool;
+		using duration      = typename blocking_pool::duration;
+
+	public:
+		explicit blocking_executor(
+			std::size_t max_threads    = blocking_pool::default_max_threads,
+			std::size_t queue_capacity = blocking_pool::default_queue_capacity,
+			duration    idle_timeout   = blocking_pool::default_idle_timeout)
+			: pool_(std::make_shared<blocking_pool>(max_threads, queue_capacity, idle_timeout)) {}
+		~blocking_executor() = default;
+
+		blocking_executor(const blocking_executor&)            = default;
+		blocking_executor(blocking_executor&&)                 = default;
+		blocking_executor& operator=(const blocking_executor&) = default;
+		blocking_executor& operator=(blocking_executor&&)      = default;
+
+		void execute(std::coroutine_handle<> handle) {
+			pool_->submit(handle);
+		}
+
+		blocking_pool& get_blocking_pool() {
+			return *pool_;
+		}
+
+	private:
+		std::shared_ptr<blocking_pool> pool_;
+	};
+
 	class timer_executor {
 	public:
 		using thread     = concurrent::timer_thread;
 		using clock      = typename thread::clock;
 		using time_point = typename thread::time_point;
 		using duration   = typename thread::duration;
-		using package    = typename thread::package;
+		using wheel      = concurrent::timing_wheel<>;
+		using backend    = concurrent::timer_backend;
 
 	public:
-		timer_executor() : thread_(std::make_shared<thread>()) {}
+		// heap: one thread over a locked priority queue, O(log n) per timer.
+		// wheel: one thread over a hierarchical timing wheel, O(1) per timer at tick (1ms) resolution.
+		// slack: how late any timer may fire. Deadlines within one slack window share a wakeup, and the sleepers
+		// it wakes are handed to each executor in one execute_bulk.
+		explicit timer_executor(backend kind = backend::heap, duration slack = duration::zero()) {
+			if (kind == backend::wheel) {
+				wheel_ = std::make_shared<wheel>(slack);
+			}
+			else {
+				thread_ = std::make_shared<thread>(slack);
+			}
+		}
 		~timer_executor() = default;
 
 		timer_executor(const timer_executor&)            = default;
@@ -125,11 +347,31 @@ namespace coflux {
 
 		template <typename Func, typename... Args>
 		void execute(Func&& func, const duration& timer = duration(), Args&&...args) {
-			thread_->submit(std::forward<Func>(func), timer, std::forward<Args>(args)...);
+			if (wheel_) {
+				wheel_->submit(std::forward<Func>(func), timer, std::forward<Args>(args)...);
+			}
+			else {
+				thread_->submit(std::forward<Func>(func), timer, std::forward<Args>(args)...);
+			}
+		}
+
+		// Links a caller-owned node (e.g. embedded in an awaiter) instead of allocating a callable.
+		void schedule(concurrent::timer_node* node, const time_point& deadline) {
+			if (wheel_) {
+				wheel_->schedule(node, deadline);
+			}
+			else {
+				thread_->schedule(node, deadline);
+			}
+		}
+
+		backend get_backend() const noexcept {
+			return wheel_ ? backend::wheel : backend::heap;
 		}
 
 	private:
 		std::shared_ptr<thread> thread_;
+		std::shared_ptr<wheel>  wheel_;
 	};
 
 	namespace detail{
@@ -152,6 +394,18 @@ namespace coflux {
 				thread_->submit(handle);
 			}
 
+			void execute_bulk(std::span<const std::coroutine_handle<>> handles) {
+				thread_->submit_bulk(handles);
+			}
+
+			bool running_in_this_thread() const noexcept {
+				return thread_->running_in_this_thread();
+			}
+
+			std::size_t size_approx() const noexcept {
+				return thread_->size_approx();
+			}
+
 		private:
 			std::shared_ptr<thread> thread_;
 		};
@@ -187,6 +441,8 @@ namespace coflux {
 
 		using queue_type   = TaskQueue;
 
+		static constexpr std::size_t rebalance_slack = 8;
+
 		template <std::size_t M>
 		using worker       = detail::worker<M, worker_group>;
 		using worker_array = std::array<detail::worker_base<worker_group>, N>;
@@ -200,9 +456,15 @@ namespace coflux {
 		worker_group& operator=(const worker_group&) = default;
 		worker_group& operator=(worker_group&&)      = default;
 
-		void execute(std::coroutine_handle<> handle) noexcept /* Call std::terminate when throw */ {
-			/* To meet the executive concept */
-			No_specified_worker_error();
+		// Every coroutine hashes to a home worker and a second choice, it goes to its home unless that queue is
+		// rebalance_slack handles deeper than the other one. Resumes from anywhere keep landing on the same thread.
+		void execute(std::coroutine_handle<> handle) {
+			auto [home, other] = Choices(handle);
+			std::size_t target = home;
+			if (workers_[other].size_approx() + rebalance_slack < workers_[home].size_approx()) {
+				target = other;
+			}
+			workers_[target].execute(handle);
 		}
 
 		template <std::size_t M>
@@ -212,8 +474,16 @@ namespace coflux {
 		}
 
 	private:
-		COFLUX_ATTRIBUTES(COFLUX_NORETURN) static void No_specified_worker_error() {
-			throw std::runtime_error("No worker is specified.");
+		static std::pair<std::size_t, std::size_t> Choices(std::coroutine_handle<> handle) noexcept {
+			// frames are at least 16 aligned, mix the rest so neighbours spread out
+			std::uint64_t hash = (std::uint64_t(reinterpret_cast<std::uintptr_t>(handle.address())) >> 4) * 0x9E3779B97F4A7C15ull;
+			std::size_t   home = std::size_t(hash >> 32) % N;
+			if constexpr (N == 1) {
+				return { home, home };
+			}
+			else {
+				return { home, (home + 1 + std::size_t(hash >> 16) % (N - 1)) % N };
+			}
 		}
 
 		worker_array workers_;
@@ -227,6 +497,137 @@ namespace coflux {
 		static constexpr std::size_t pos = M;
 	};
 
+	namespace detail {
+		template <typename Group>
+		class shard_base {
+		public:
+			using owner_group = Group;
+			using shard_group = typename Group::shard_group;
+
+		public:
+			shard_base() = default;
+			shard_base(std::shared_ptr<shard_group> group, std::size_t index)
+				: group_(std::move(group)), index_(index) {}
+			~shard_base() = default;
+
+			shard_base(const shard_base&)            = default;
+			shard_base(shard_base&&)                 = default;
+			shard_base& operator=(const shard_base&) = default;
+			shard_base& operator=(shard_base&&)      = default;
+
+			void execute(std::coroutine_handle<> handle) {
+				group_->submit(index_, handle);
+			}
+
+			bool running_in_this_thread() const noexcept {
+				return group_->current() == index_;
+			}
+
+			// The timer is kept by the shard itself, no timer thread is involved.
+			template <typename Rep, typename Period>
+			void execute_after(std::coroutine_handle<> handle, const std::chrono::duration<Rep, Period>& delay) {
+				group_->submit_after(index_, handle, delay);
+			}
+
+			// Sleeps issued on this shard stay on it, see shard_group::try_schedule_local.
+			bool try_schedule_local(concurrent::timer_node* node, std::chrono::steady_clock::time_point deadline) {
+				return group_->try_schedule_local(index_, node, deadline);
+			}
+
+		private:
+			std::shared_ptr<shard_group> group_;
+			std::size_t                  index_ = 0;
+		};
+
+		template <std::size_t M, typename Group>
+		class shard : public shard_base<Group> {
+		public:
+			using base        = shard_base<Group>;
+			using owner_group = typename base::owner_group;
+
+			static constexpr std::size_t pos = M;
+
+		public:
+			shard()  = default;
+			~shard() = default;
+
+			shard(const shard&)            = default;
+			shard(shard&&)                 = default;
+			shard& operator=(const shard&) = default;
+			shard& operator=(shard&&)      = default;
+
+			void execute(std::coroutine_handle<> handle) {
+				base::execute(handle);
+			}
+		};
+	}
+
+	// Thread-per-core: a coroutine stays on the shard it is sent to, shards talk through per-pair SPSC rings.
+	template <std::size_t N, typename Constants = concurrent::default_shard_group_constants>
+	class sharded_executor {
+	public:
+		static_assert(N, "N shoud be larger than zero");
+
+		using shard_group = concurrent::shard_group<N, Constants>;
+
+		template <std::size_t M>
+		using shard       = detail::shard<M, sharded_executor>;
+		using shard_array = std::array<detail::shard_base<sharded_executor>, N>;
+
+	public:
+		sharded_executor() : group_(std::make_shared<shard_group>()) {
+			for (std::size_t i = 0; i < N; i++) {
+				shards_[i] = detail::shard_base<sharded_executor>(group_, i);
+			}
+		}
+		~sharded_executor() = default;
+
+		sharded_executor(const sharded_executor&)            = default;
+		sharded_executor(sharded_executor&&)                 = default;
+		sharded_executor& operator=(const sharded_executor&) = default;
+		sharded_executor& operator=(sharded_executor&&)      = default;
+
+		// Untagged work stays on the calling shard, work from outside is spread round robin.
+		void execute(std::coroutine_handle<> handle) {
+			std::size_t target = group_->current();
+			if (target == N) {
+				target = group_->next_target();
+			}
+			group_->submit(target, handle);
+		}
+
+		bool running_in_this_thread() const noexcept {
+			return group_->current() != N;
+		}
+
+		// A sleep issued on a shard is kept by that shard, like the work it resumes into.
+		bool try_schedule_local(concurrent::timer_node* node, std::chrono::steady_clock::time_point deadline) {
+			return group_->try_schedule_local(group_->current(), node, deadline);
+		}
+
+		template <std::size_t M>
+		auto& get() noexcept {
+			static_assert(M < N, "shard_index out of range.");
+			return *static_cast<shard<M>*>(&shards_[M]);
+		}
+
+		shard_group& get_shard_group() {
+			return *group_;
+		}
+
+	private:
+		std::shared_ptr<shard_group> group_;
+		shard_array                  shards_;
+	};
+
+	template <std::size_t M, typename Group, std::size_t N>
+	struct index<detail::shard<M, Group>, N> : std::integral_constant<std::size_t, N> {
+		using type        = Group;
+		using owner_group = Group;
+
+		static constexpr std::size_t pos = M;
+	};
+
 	namespace detail {
 		template <executive_or_certain_executor Executor>
 		struct executor_type_traits;
@@ -271,6 +672,26 @@ namespace coflux {
 				}
 			}
 
+			static void execute_bulk(executor_pointer exec, std::span<const std::coroutine_handle<>> handles) {
+				if constexpr (executive_bulk<executor_type>) {
+					exec->execute_bulk(handles);
+				}
+				else {
+					for (std::coroutine_handle<> handle : handles) {
+						execute(exec, handle);
+					}
+				}
+			}
+
+			static bool running_in_this_thread(executor_pointer exec) noexcept {
+				if constexpr (executive_affine<executor_type>) {
+					return exec->running_in_this_thread();
+				}
+				else {
+					return false;
+				}
+			}
+
 			template <typename Func, typename...Args>
 			static void execute(executor_pointer exec, Func&& func, Args&&...args) {
 				exec->execute(std::forward<Func>(func), std::forward<Args>(args)...);
@@ -151,6 +151,11 @@ namespace coflux {
 				return static_cast<std::coroutine_handle<>>(handle_);
 			}
 
+			// See promise_fork_base::try_set_continuation, used by awaiter from inside a completion callback.
+			bool try_set_continuation(std::coroutine_handle<> waiter) noexcept {
+				return handle_ && handle_.promise().try_set_continuation(waiter);
+			}
+
 			template <typename Func>
 			basic_task& then(Func && func)& {
 				if (!handle_) COFLUX_ATTRIBUTES(COFLUX_UNLIKELY) {
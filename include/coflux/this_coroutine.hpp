@@ -85,14 +85,16 @@ namespace coflux {
         };
 
         template <executive Executor>
-        struct sleep_awaiter : public maysuspend_awaiter_base<Executor> {
+        struct sleep_awaiter : public maysuspend_awaiter_base<Executor>, private concurrent::timer_node {
             using suspend_base     = maysuspend_awaiter_base<Executor>;
             using executor_type    = typename suspend_base::executor_type;
             using executor_pointer = typename suspend_base::executor_pointer;
+            using clock            = std::chrono::steady_clock;
+            using time_point       = clock::time_point;
 
-            sleep_awaiter(std::chrono::milliseconds timer, std::atomic<status>* st)
+            sleep_awaiter(time_point deadline, std::atomic<status>* st)
                 : suspend_base(st)
-                , timer_(timer) {}
+                , deadline_(deadline) {}
             ~sleep_awaiter() = default;
 
             sleep_awaiter(const sleep_awaiter&)            = delete;
@@ -104,30 +106,195 @@ namespace coflux {
                 return false;
             }
 
+            // The awaiter itself is the timer node: it lives in the suspended frame, so the timer links it
+            // in directly and neither a callable nor a copy of the executor is allocated per sleep.
             template <typename Promise>
-            void await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            bool await_suspend(std::coroutine_handle<Promise> handle) {
                 suspend_base::await_suspend();
-                auto& sch = handle.promise().scheduler_;
+                auto& promise = handle.promise();
+                auto& sch     = promise.scheduler_;
                 suspend_base::set_executor_ptr(&sch.template get<Executor>());
-                executor_traits<timer_executor>::execute(
-                    &sch.template get<timer_executor>(),
-                    [this, handle, target_exec = sch.template get<Executor>()]() mutable { 
-                        suspend_base::execute(&target_exec, handle);
-                    },
-                    timer_
-                );
+                ownership_ = std::is_base_of_v<promise_fork_base<true>, Promise>;
+                if (promise.stop_source_.stop_requested()) {
+                    cancelled_ = true;
+                    return false;
+                }
+                // A deadline already behind us just goes back to the executor, like a yield.
+                if (deadline_ <= clock::now()) {
+                    suspend_base::execute(handle);
+                    return true;
+                }
+                handle_ = handle;
+                this->invoke = &sleep_awaiter::Wake;
+                bool local = false;
+                // A worker that keeps its own timers fires it itself and resumes us right there.
+                if constexpr (requires{ suspend_base::executor_->try_schedule_local(this, deadline_); }) {
+                    local = suspend_base::executor_->try_schedule_local(this, deadline_);
+                }
+                if (!local) {
+                    sch.template get<timer_executor>().schedule(this, deadline_);
+                }
+                // A stop request takes the node out of its timer, which hands it back to Wake as not fired.
+                stop_callback_.emplace(promise.stop_source_.get_token(), stop_request{ this });
+                // Whichever of us and Wake comes second resumes, so Wake never races the emplace above.
+                return !Arrive();
             }
 
-            void await_resume() noexcept {
+            void await_resume() {
+                stop_callback_.reset();
                 suspend_base::await_resume();
+                if (cancelled_) {
+                    throw cancel_exception(ownership_);
+                }
+            }
+
+            time_point              deadline_;
+            std::coroutine_handle<> handle_;
+
+        protected:
+            // Only once the previous wait has been resumed, the timer no longer refers to the node by then.
+            void Rearm(time_point deadline) noexcept {
+                deadline_ = deadline;
+                this->st.store(concurrent::timer_node::armed, std::memory_order_relaxed);
+                gate_.store(2, std::memory_order_relaxed);
+                cancelled_ = false;
+            }
+
+        private:
+            struct stop_request {
+                void operator()() const noexcept {
+                    concurrent::cancel_timer(self_);
+                }
+
+                sleep_awaiter* self_;
+            };
+
+            bool Arrive() noexcept {
+                return gate_.fetch_sub(1, std::memory_order_acq_rel) == 1;
+            }
+
+            static void Wake(concurrent::timer_node* node, bool fire) {
+                auto* self = static_cast<sleep_awaiter*>(node);
+                if (!fire) {
+                    // Dropped by a timer that shut down, nobody resumes us.
+                    if (node->st.load(std::memory_order_acquire) == concurrent::timer_node::fired) {
+                        return;
+                    }
+                    self->cancelled_ = true;
+                }
+                if (self->Arrive()) {
+                    // Fired in a pass of a timer thread: resumed together with the other sleepers of that pass.
+                    if (auto* batch = concurrent::timer_batch::current()) {
+                        batch->add(self->executor_, &sleep_awaiter::Dispatch, self->handle_);
+                    }
+                    else {
+                        self->execute(self->handle_);
+                    }
+                }
+            }
+
+            static void Dispatch(void* exec, std::span<const std::coroutine_handle<>> handles) {
+                suspend_base::executor_traits::execute_bulk(static_cast<executor_pointer>(exec), handles);
+            }
+
+            std::optional<std::stop_callback<stop_request>> stop_callback_;
+            std::atomic_int                                 gate_      = 2;
+            bool                                            cancelled_ = false;
+            bool                                            ownership_ = false;
+        };
+
+        /*
+        *           One timer node for a whole periodic loop. Ticks are due at start + k * period however late the
+        *           loop body was, so nothing drifts. A tick that has already passed is taken without suspending,
+        *           and every whole period overslept is skipped and reported as missed by co_await.
+        */
+        template <bool Ownership, executive Executor>
+        struct interval_timer : public sleep_awaiter<Executor>, public ownership_tag<Ownership> {
+            using sleep_base = sleep_awaiter<Executor>;
+            using clock      = typename sleep_base::clock;
+            using time_point = typename sleep_base::time_point;
+            using duration   = clock::duration;
+
+            interval_timer(time_point first, duration period, std::atomic<status>* st, std::stop_token token)
+                : sleep_base(first, st)
+                , period_(period)
+                , token_(std::move(token)) {}
+            ~interval_timer() = default;
+
+            interval_timer(const interval_timer&)            = delete;
+            interval_timer(interval_timer&&)                 = delete;
+            interval_timer& operator=(const interval_timer&) = delete;
+            interval_timer& operator=(interval_timer&&)      = delete;
+
+            // Awaited through a small proxy, the timer itself stays where it is.
+            interval_awaiter<Ownership, Executor> operator co_await() & noexcept {
+                return interval_awaiter<Ownership, Executor>{ this };
+            }
+
+            bool await_ready() const noexcept {
+                return this->deadline_ <= clock::now();
             }
 
-            std::chrono::milliseconds timer_;
+            template <typename Promise>
+            bool await_suspend(std::coroutine_handle<Promise> handle) {
+                sleep_base::Rearm(this->deadline_);
+                waited_ = true;
+                return sleep_base::await_suspend(handle);
+            }
+
+            // The number of ticks missed since the previous one.
+            std::size_t await_resume() {
+                if (std::exchange(waited_, false)) {
+                    sleep_base::await_resume();
+                }
+                // A late tick never suspends, so a loop that always runs behind would otherwise never see a stop request.
+                else if (token_.stop_requested()) {
+                    throw cancel_exception(Ownership);
+                }
+                duration    late   = clock::now() - this->deadline_;
+                std::size_t missed = late >= period_ ? std::size_t(late / period_) : 0;
+                this->deadline_ += period_ * (missed + 1);
+                return missed;
+            }
+
+            duration period() const noexcept {
+                return period_;
+            }
+
+            // Where the next tick is due.
+            time_point next_tick() const noexcept {
+                return this->deadline_;
+            }
+
+        private:
+            duration        period_;
+            std::stop_token token_;
+            bool            waited_ = false;
+        };
+
+        template <bool Ownership, executive Executor>
+        struct interval_awaiter {
+            bool await_ready() const noexcept {
+                return timer_->await_ready();
+            }
+
+            template <typename Promise>
+            bool await_suspend(std::coroutine_handle<Promise> handle) {
+                return timer_->await_suspend(handle);
+            }
+
+            std::size_t await_resume() {
+                return timer_->await_resume();
+            }
+
+            interval_timer<Ownership, Executor>* timer_;
         };
 
         template <bool Ownership, typename Rep, typename Period>
         struct sleep_t : public ownership_tag<Ownership> {
-            sleep_t(const std::chrono::duration<Rep, Period>& dur) : dur_(dur) {}
+            sleep_t(const std::chrono::duration<Rep, Period>& dur, std::chrono::steady_clock::duration slack = {})
+                : dur_(dur)
+                , slack_(slack) {}
             ~sleep_t() = default;
             
             sleep_t(const sleep_t&)            = delete;
@@ -135,7 +302,75 @@ namespace coflux {
             sleep_t& operator=(const sleep_t&) = delete;
             sleep_t& operator=(sleep_t&&)      = default;
 
-            std::chrono::duration<Rep, Period> dur_;
+            std::chrono::duration<Rep, Period>  dur_;
+            std::chrono::steady_clock::duration slack_;
+        };
+
+        template <bool Ownership, typename Duration>
+        struct sleep_until_t : public ownership_tag<Ownership> {
+            sleep_until_t(const std::chrono::time_point<std::chrono::steady_clock, Duration>& deadline, std::chrono::steady_clock::duration slack = {})
+                : deadline_(deadline)
+                , slack_(slack) {}
+            ~sleep_until_t() = default;
+
+            sleep_until_t(const sleep_until_t&)            = delete;
+            sleep_until_t(sleep_until_t&&)                 = default;
+            sleep_until_t& operator=(const sleep_until_t&) = delete;
+            sleep_until_t& operator=(sleep_until_t&&)      = default;
+
+            std::chrono::time_point<std::chrono::steady_clock, Duration> deadline_;
+            std::chrono::steady_clock::duration                          slack_;
+        };
+
+        template <bool Ownership, typename Rep, typename Period>
+        struct interval_t : public ownership_tag<Ownership> {
+            interval_t(const std::chrono::duration<Rep, Period>& period) : period_(period) {}
+            ~interval_t() = default;
+
+            interval_t(const interval_t&)            = delete;
+            interval_t(interval_t&&)                 = default;
+            interval_t& operator=(const interval_t&) = delete;
+            interval_t& operator=(interval_t&&)      = default;
+
+            std::chrono::duration<Rep, Period> period_;
+        };
+
+        template <bool Ownership, executive Executor>
+        struct get_interval_awaiter : public nonsuspend_awaiter_base, public ownership_tag<Ownership> {
+            using clock = std::chrono::steady_clock;
+
+            get_interval_awaiter(clock::duration period, std::atomic<status>* st, std::stop_token token)
+                : period_(period)
+                , waiter_status_(st)
+                , token_(std::move(token)) {}
+            ~get_interval_awaiter() = default;
+
+            get_interval_awaiter(const get_interval_awaiter&)            = delete;
+            get_interval_awaiter(get_interval_awaiter&&)                 = default;
+            get_interval_awaiter& operator=(const get_interval_awaiter&) = delete;
+            get_interval_awaiter& operator=(get_interval_awaiter&&)      = default;
+
+            bool await_ready() const noexcept {
+                return true;
+            }
+
+            void await_suspend(std::coroutine_handle<> handle) noexcept {}
+
+            // The first tick is one period from now.
+            interval_timer<Ownership, Executor> await_resume() const {
+                if (period_ <= clock::duration::zero()) {
+                    Period_error();
+                }
+                return interval_timer<Ownership, Executor>(clock::now() + period_, period_, waiter_status_, token_);
+            }
+
+            COFLUX_ATTRIBUTES(COFLUX_NORETURN) static void Period_error() {
+                throw std::runtime_error("The period of an interval should be larger than zero.");
+            }
+
+            clock::duration      period_;
+            std::atomic<status>* waiter_status_;
+            std::stop_token      token_;
         };
 
         template <bool Ownership>
@@ -171,6 +406,62 @@ namespace coflux {
         template <bool Ownership>
         struct cancel_t : public ownership_tag<Ownership> {};
 
+        template <bool Ownership>
+        struct set_deadline_awaiter : public nonsuspend_awaiter_base, public ownership_tag<Ownership> {
+            using time_point = concurrent::deadline_registry::time_point;
+
+            explicit set_deadline_awaiter(time_point deadline) : deadline_(deadline) {}
+            ~set_deadline_awaiter() = default;
+
+            set_deadline_awaiter(const set_deadline_awaiter&)            = delete;
+            set_deadline_awaiter(set_deadline_awaiter&&)                 = default;
+            set_deadline_awaiter& operator=(const set_deadline_awaiter&) = delete;
+            set_deadline_awaiter& operator=(set_deadline_awaiter&&)      = default;
+
+            bool await_ready() const noexcept {
+                return false;
+            }
+
+            template <typename Promise>
+            bool await_suspend(std::coroutine_handle<Promise> handle) {
+                handle.promise().set_deadline(deadline_);
+                return false;
+            }
+
+            void await_resume() const noexcept {}
+
+            time_point deadline_;
+        };
+
+        template <bool Ownership>
+        struct get_deadline_awaiter : public nonsuspend_awaiter_base, public ownership_tag<Ownership> {
+            using time_point = concurrent::deadline_registry::time_point;
+
+            get_deadline_awaiter()  = default;
+            ~get_deadline_awaiter() = default;
+
+            get_deadline_awaiter(const get_deadline_awaiter&)            = delete;
+            get_deadline_awaiter(get_deadline_awaiter&&)                 = default;
+            get_deadline_awaiter& operator=(const get_deadline_awaiter&) = delete;
+            get_deadline_awaiter& operator=(get_deadline_awaiter&&)      = default;
+
+            bool await_ready() const noexcept {
+                return false;
+            }
+
+            template <typename Promise>
+            bool await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+                deadline_ = handle.promise().deadline_;
+                return false;
+            }
+
+            time_point await_resume() const noexcept {
+                return deadline_;
+            }
+
+            time_point deadline_ = concurrent::deadline_registry::none;
+        };
+
         template <bool Ownership>
         struct destroy_forks_awaiter : public nonsuspend_awaiter_base, public ownership_tag<Ownership> {
             destroy_forks_awaiter()  = default;
@@ -414,6 +705,29 @@ namespace coflux {
             return detail::sleep_t<true, Rep, Period>{sleep_time};
         }
 
+        // May wake up to slack late, which lets sleeps ending in the same slack window share one timer wakeup.
+        template <typename Rep, typename Period, typename SlackRep, typename SlackPeriod>
+        inline auto sleep_for(const std::chrono::duration<Rep, Period>& sleep_time, const std::chrono::duration<SlackRep, SlackPeriod>& slack) noexcept {
+            return detail::sleep_t<true, Rep, Period>{sleep_time, std::chrono::ceil<std::chrono::steady_clock::duration>(slack)};
+        }
+
+        // Sleeps are kept at steady_clock resolution, how close the wakeup lands depends on the timer behind them.
+        template <typename Duration>
+        inline auto sleep_until(const std::chrono::time_point<std::chrono::steady_clock, Duration>& deadline) noexcept {
+            return detail::sleep_until_t<true, Duration>{deadline};
+        }
+
+        template <typename Duration, typename SlackRep, typename SlackPeriod>
+        inline auto sleep_until(const std::chrono::time_point<std::chrono::steady_clock, Duration>& deadline, const std::chrono::duration<SlackRep, SlackPeriod>& slack) noexcept {
+            return detail::sleep_until_t<true, Duration>{deadline, std::chrono::ceil<std::chrono::steady_clock::duration>(slack)};
+        }
+
+        // auto ticker = co_await interval(period); then std::size_t missed = co_await ticker; once per tick.
+        template <typename Rep, typename Period>
+        inline auto interval(const std::chrono::duration<Rep, Period>& period) noexcept {
+            return detail::interval_t<true, Rep, Period>{period};
+        }
+
         inline auto yield() noexcept {
             return detail::yield_t<true>{};
         }
@@ -426,6 +740,17 @@ namespace coflux {
             return detail::cancel_t<true>{};
         }
 
+        // deadline operations, forks created afterwards inherit the deadline.
+        // edf_executor runs the earliest deadline first, other executors ignore it.
+        template <typename Duration>
+        inline auto set_deadline(const std::chrono::time_point<std::chrono::steady_clock, Duration>& deadline) noexcept {
+            return detail::set_deadline_awaiter<true>{ std::chrono::time_point_cast<std::chrono::steady_clock::duration>(deadline) };
+        }
+
+        inline auto get_deadline() noexcept {
+            return detail::get_deadline_awaiter<true>{};
+        }
+
         // fork operations
         inline auto destroy_forks() noexcept {
             return detail::destroy_forks_awaiter<true>{};
@@ -460,6 +785,27 @@ namespace coflux {
             return detail::sleep_t<false, Rep, Period>{sleep_time};
         }
 
+        // May wake up to slack late, which lets sleeps ending in the same slack window share one timer wakeup.
+        template <typename Rep, typename Period, typename SlackRep, typename SlackPeriod>
+        inline auto sleep_for(const std::chrono::duration<Rep, Period>& sleep_time, const std::chrono::duration<SlackRep, SlackPeriod>& slack) noexcept {
+            return detail::sleep_t<false, Rep, Period>{sleep_time, std::chrono::ceil<std::chrono::steady_clock::duration>(slack)};
+        }
+
+        template <typename Duration>
+        inline auto sleep_until(const std::chrono::time_point<std::chrono::steady_clock, Duration>& deadline) noexcept {
+            return detail::sleep_until_t<false, Duration>{deadline};
+        }
+
+        template <typename Duration, typename SlackRep, typename SlackPeriod>
+        inline auto sleep_until(const std::chrono::time_point<std::chrono::steady_clock, Duration>& deadline, const std::chrono::duration<SlackRep, SlackPeriod>& slack) noexcept {
+            return detail::sleep_until_t<false, Duration>{deadline, std::chrono::ceil<std::chrono::steady_clock::duration>(slack)};
+        }
+
+        template <typename Rep, typename Period>
+        inline auto interval(const std::chrono::duration<Rep, Period>& period) noexcept {
+            return detail::interval_t<false, Rep, Period>{period};
+        }
+
         inline auto yield() noexcept {
             return detail::yield_t<false>{};
         }
@@ -472,6 +818,17 @@ namespace coflux {
             return detail::cancel_t<false>{};
         }
 
+        // deadline operations, forks created afterwards inherit the deadline.
+        // edf_executor runs the earliest deadline first, other executors ignore it.
+        template <typename Duration>
+        inline auto set_deadline(const std::chrono::time_point<std::chrono::steady_clock, Duration>& deadline) noexcept {
+            return detail::set_deadline_awaiter<false>{ std::chrono::time_point_cast<std::chrono::steady_clock::duration>(deadline) };
+        }
+
+        inline auto get_deadline() noexcept {
+            return detail::get_deadline_awaiter<false>{};
+        }
+
         // fork operations
         inline auto destroy_forks() noexcept {
             return detail::destroy_forks_awaiter<false>{};
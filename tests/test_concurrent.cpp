@@ -0,0 +1,1452 @@
+#include <gtest/gtest.h>
+#include <coflux/task.hpp>
+#include <coflux/combiner.hpp>
+#include <coflux/executor.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <latch>
+#include <mutex>
+
+using namespace coflux;
+
+using handle_type = std::coroutine_handle<>;
+
+// 用普通对象的地址充当句柄, 只比较不恢复
+static handle_type as_handle(int& v) {
+    return handle_type::from_address(&v);
+}
+
+// --- 1. ChaseLev_deque 单线程: 扩容与 LIFO 顺序 ---
+TEST(ConcurrentTest, ChaseLevDequeGrowsAndKeepsOrder) {
+    concurrent::ChaseLev_deque<handle_type, 4, 64> deque;
+    std::vector<int> values(1000);
+
+    for (auto& v : values) {
+        ASSERT_TRUE(deque.try_push_back(as_handle(v)));
+    }
+    EXPECT_EQ(deque.size_approx(), values.size());
+    EXPECT_GE(deque.capacity(), values.size());
+
+    // 队头(窃取端)拿到最早的元素, 队尾(所有者)拿到最新的元素
+    EXPECT_EQ(deque.try_pop_front(), as_handle(values.front()));
+    for (std::size_t i = values.size() - 1; i > 0; i--) {
+        EXPECT_EQ(deque.try_pop_back(), as_handle(values[i]));
+    }
+    EXPECT_FALSE(deque.try_pop_back());
+    EXPECT_TRUE(deque.empty());
+}
+
+// --- 2. ChaseLev_deque 并发窃取: 扩容期间每个元素恰好被取走一次 ---
+TEST(ConcurrentTest, ChaseLevDequeConcurrentSteal) {
+    constexpr int ITEMS = 200000;
+    constexpr int THIEVES = 3;
+
+    concurrent::ChaseLev_deque<handle_type, 8, 64> deque;
+    std::vector<int> values(ITEMS);
+    std::vector<std::atomic<int>> taken(ITEMS);
+    std::atomic_bool done = false;
+
+    auto take = [&](handle_type h) {
+        taken[static_cast<int*>(h.address()) - values.data()].fetch_add(1, std::memory_order_relaxed);
+        };
+
+    std::vector<std::thread> thieves;
+    for (int i = 0; i < THIEVES; i++) {
+        thieves.emplace_back([&]() {
+            while (!done.load(std::memory_order_acquire) || !deque.empty()) {
+                if (handle_type h = deque.try_pop_front()) {
+                    take(h);
+                }
+            }
+            });
+    }
+
+    // 所有者批量压入后只弹出一部分, 迫使缓冲区在窃取者活跃时反复扩容
+    for (int i = 0; i < ITEMS; i++) {
+        deque.try_push_back(as_handle(values[i]));
+        if (i % 3 == 0) {
+            if (handle_type h = deque.try_pop_back()) {
+                take(h);
+            }
+        }
+    }
+    while (handle_type h = deque.try_pop_back()) {
+        take(h);
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& t : thieves) {
+        t.join();
+    }
+
+    for (int i = 0; i < ITEMS; i++) {
+        ASSERT_EQ(taken[i].load(), 1) << "at " << i;
+    }
+}
+
+// --- 3. 可扩容本地队列的线程池: 递归 fork 大量子任务 ---
+struct growable_constants {
+    static constexpr std::size_t WORKSTEAL_LOCAL_QUEUE_CAPACITY = 4;
+    static constexpr bool        WORKSTEAL_LOCAL_QUEUE_GROWABLE = true;
+};
+
+using GrowableExecutor  = thread_pool_executor<concurrent::unbounded_queue<>, growable_constants>;
+using GrowableScheduler = scheduler<GrowableExecutor>;
+
+template <typename Executor>
+coflux::fork<int, Executor> fib(auto&&, int n) {
+    if (n < 2) {
+        co_return n;
+    }
+    auto&& ctx = co_await context();
+    auto a = fib<Executor>(ctx, n - 1);
+    auto b = fib<Executor>(ctx, n - 2);
+    co_return co_await a + co_await b;
+}
+
+TEST(ConcurrentTest, GrowableLocalQueueForkTree) {
+    auto env = make_environment(GrowableScheduler{ GrowableExecutor{ 2 } });
+    auto test = [](auto env) -> task<int, GrowableExecutor, GrowableScheduler> {
+        co_return co_await fib<GrowableExecutor>(co_await context(), 16);
+        }(env);
+
+    EXPECT_EQ(test.get_result(), 987);
+}
+
+// --- 4. parker: 先于 park 到达的 unpark 不会丢失, 无人唤醒时 park_for 超时返回 ---
+TEST(ConcurrentTest, ParkerDoesNotLoseWakeup) {
+    concurrent::parker parker;
+
+    EXPECT_FALSE(parker.try_unpark());
+    EXPECT_FALSE(parker.park_for(std::chrono::milliseconds(10)));
+
+    parker.prepare_park();
+    EXPECT_TRUE(parker.try_unpark());
+    EXPECT_TRUE(parker.park_for(std::chrono::milliseconds(10)));
+    EXPECT_FALSE(parker.is_parked());
+
+    parker.prepare_park();
+    std::thread waker([&]() {
+        while (!parker.try_unpark()) {
+            std::this_thread::yield();
+        }
+        });
+    parker.park();
+    waker.join();
+    EXPECT_FALSE(parker.is_parked());
+}
+
+
+// --- 5. 拓扑感知线程池: 绑核 + 按节点注入 + 由近及远窃取 ---
+struct topology_constants {
+    static constexpr bool WORKSTEAL_TOPOLOGY_AWARE = true;
+};
+
+using TopologyExecutor  = thread_pool_executor<concurrent::unbounded_queue<>, topology_constants>;
+using TopologyScheduler = scheduler<TopologyExecutor>;
+
+TEST(ConcurrentTest, TopologyAwarePoolForkTree) {
+    auto topo = concurrent::topology::detect();
+    ASSERT_FALSE(topo.cpus().empty());
+    EXPECT_GE(topo.node_size(), 1u);
+    for (std::size_t i = 0; i < topo.cpus().size(); i++) {
+        EXPECT_EQ(topo.distance_between(i, i), concurrent::topology::self);
+        EXPECT_LT(topo.cpus()[i].node, topo.node_size());
+    }
+
+    auto env = make_environment(TopologyScheduler{ TopologyExecutor{ 4 } });
+    auto test = [](auto env) -> task<int, TopologyExecutor, TopologyScheduler> {
+        co_return co_await fib<TopologyExecutor>(co_await context(), 16);
+        }(env);
+
+    EXPECT_EQ(test.get_result(), 987);
+}
+
+// --- 6. segmented_queue 多生产者多消费者: 段频繁回收时每个元素恰好出队一次 ---
+struct small_segments {
+    static constexpr std::size_t SEGMENT_SIZE = 4;
+};
+
+TEST(ConcurrentTest, SegmentedQueueMPMC) {
+    constexpr int PRODUCERS = 3;
+    constexpr int CONSUMERS = 3;
+    constexpr int ITEMS     = 60000;
+
+    concurrent::segmented_queue<small_segments> queue;
+    std::vector<int> values(ITEMS);
+    std::vector<std::atomic<int>> taken(ITEMS);
+    std::atomic_int consumed = 0;
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < PRODUCERS; p++) {
+        threads.emplace_back([&, p]() {
+            for (int i = p; i < ITEMS; i += PRODUCERS) {
+                queue.enqueue(as_handle(values[i]));
+            }
+            });
+    }
+    for (int c = 0; c < CONSUMERS; c++) {
+        threads.emplace_back([&, c]() {
+            std::array<handle_type, 8> buffer;
+            while (consumed.load(std::memory_order_relaxed) < ITEMS) {
+                std::size_t n = c == 0
+                    ? queue.wait_dequeue_bulk_timed(buffer.begin(), buffer.size(), std::chrono::milliseconds(1))
+                    : queue.try_dequeue_bulk(buffer.begin(), buffer.size());
+                for (std::size_t i = 0; i < n; i++) {
+                    taken[static_cast<int*>(buffer[i].address()) - values.data()].fetch_add(1, std::memory_order_relaxed);
+                }
+                consumed.fetch_add(int(n), std::memory_order_relaxed);
+            }
+            });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    EXPECT_TRUE(queue.empty());
+    for (int i = 0; i < ITEMS; i++) {
+        ASSERT_EQ(taken[i].load(), 1) << "at " << i;
+    }
+}
+
+// --- 7. 优先级线程池: 唯一的工作线程被占用时, 高优先级任务先于低优先级任务执行 ---
+struct no_aging_constants {
+    static constexpr std::size_t PRIORITY_AGING_INTERVAL = std::size_t(1) << 20;
+};
+
+using PriorityExecutor  = priority_thread_pool_executor<2, concurrent::segmented_queue<>, no_aging_constants>;
+using PriorityScheduler = scheduler<PriorityExecutor>;
+
+TEST(ConcurrentTest, PriorityLevelsRunUrgentFirst) {
+    auto env = make_environment(PriorityScheduler{ PriorityExecutor{ 1 } });
+    std::latch  release(1);
+    std::mutex  mtx;
+    std::vector<int> order;
+
+    auto record = [&](int level) {
+        std::lock_guard<std::mutex> guard(mtx);
+        order.push_back(level);
+        };
+
+    auto blocker = [](auto env, std::latch& release) -> task<void, PriorityExecutor::level<0>, PriorityScheduler> {
+        release.wait();
+        co_return;
+        }(env, release);
+
+    std::vector<task<void, PriorityExecutor::level<1>, PriorityScheduler>> lows;
+    std::vector<task<void, PriorityExecutor::level<0>, PriorityScheduler>> highs;
+    for (int i = 0; i < 3; i++) {
+        lows.push_back([](auto env, auto& record) -> task<void, PriorityExecutor::level<1>, PriorityScheduler> {
+            record(1);
+            co_return;
+            }(env, record));
+    }
+    for (int i = 0; i < 3; i++) {
+        highs.push_back([](auto env, auto& record) -> task<void, PriorityExecutor::level<0>, PriorityScheduler> {
+            record(0);
+            co_return;
+            }(env, record));
+    }
+    release.count_down();
+    blocker.join();
+    for (auto& t : highs) t.join();
+    for (auto& t : lows)  t.join();
+
+    EXPECT_EQ(order, std::vector<int>({ 0, 0, 0, 1, 1, 1 }));
+}
+
+// --- 8. 自适应控制器: 按采样调整自旋次数和批量大小, 开启后线程池照常工作 ---
+struct adaptive_constants {
+    static constexpr bool        ADAPTIVE_CONTROLLER          = true;
+    static constexpr std::size_t ADAPTIVE_PERIOD_MICROSECONDS = 0;
+};
+
+struct fake_worker {
+    const concurrent::adaptive_sample& sample() const noexcept {
+        return sample_;
+    }
+    concurrent::adaptive_sample sample_;
+};
+
+using AdaptiveTraits     = concurrent::thread_pool_constant_traits<adaptive_constants>;
+using AdaptiveController = concurrent::adaptive_controller<AdaptiveTraits>;
+using AdaptiveExecutor   = thread_pool_executor<concurrent::segmented_queue<>, adaptive_constants>;
+using AdaptiveScheduler  = scheduler<AdaptiveExecutor>;
+
+TEST(ConcurrentTest, AdaptiveControllerRetunesKnobs) {
+    AdaptiveController controller;
+    std::vector<std::unique_ptr<fake_worker>> workers;
+    workers.push_back(std::make_unique<fake_worker>());
+    std::vector<std::unique_ptr<concurrent::segmented_queue<>>> queues;
+    auto& s = workers[0]->sample_;
+
+    std::size_t spin_budget = controller.spin_budget();
+    std::size_t batch_size  = controller.batch_size();
+
+    // 自旋总能找到任务 -> 自旋预算翻倍; 批量被频繁窃取 -> 批量减半
+    concurrent::adaptive_sample::add(s.spins, 10);
+    concurrent::adaptive_sample::add(s.spin_hits, 10);
+    concurrent::adaptive_sample::add(s.refills, 10);
+    concurrent::adaptive_sample::add(s.refilled, 10 * batch_size);
+    concurrent::adaptive_sample::add(s.refill_capacity, 10 * batch_size);
+    concurrent::adaptive_sample::add(s.steals, 10);
+    controller.maybe_update(workers, queues);
+    EXPECT_EQ(controller.spin_budget(), spin_budget * 2);
+    EXPECT_EQ(controller.batch_size(), batch_size / 2);
+
+    // 自旋几乎总是落空 -> 自旋预算减半
+    concurrent::adaptive_sample::add(s.spins, 100);
+    controller.maybe_update(workers, queues);
+    EXPECT_EQ(controller.spin_budget(), spin_budget);
+
+    auto env = make_environment(AdaptiveScheduler{ AdaptiveExecutor{ 2 } });
+    auto test = [](auto env) -> task<int, AdaptiveExecutor, AdaptiveScheduler> {
+        co_return co_await fib<AdaptiveExecutor>(co_await context(), 16);
+        }(env);
+
+    EXPECT_EQ(test.get_result(), 987);
+}
+
+// --- 9. 关闭线程池: drain 先跑完排队的任务, abort 把没跑的句柄交还调用者 ---
+struct bare_coroutine {
+    struct promise_type {
+        bare_coroutine get_return_object() {
+            return { std::coroutine_handle<promise_type>::from_promise(*this) };
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never  final_suspend()   noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() { std::terminate(); }
+    };
+    std::coroutine_handle<> handle;
+};
+
+static bare_coroutine bump(std::atomic_int& counter) {
+    counter.fetch_add(1);
+    co_return;
+}
+
+static bare_coroutine block(std::latch& started, std::latch& release) {
+    started.count_down();
+    release.wait();
+    co_return;
+}
+
+using ShutdownPool = concurrent::thread_pool<concurrent::segmented_queue<>, concurrent::default_thread_pool_constants>;
+
+TEST(ConcurrentTest, ShutdownDrainAndAbort) {
+    for (auto how : { concurrent::shutdown_mode::drain, concurrent::shutdown_mode::abort }) {
+        ShutdownPool pool(1);
+        std::atomic_int counter = 0;
+        std::latch started(1), release(1);
+        pool.submit(block(started, release).handle);
+        started.wait();
+        for (int i = 0; i < 100; i++) {
+            pool.submit(bump(counter).handle);
+        }
+        std::thread releaser([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            release.count_down();
+            });
+        auto dropped = pool.shutdown(how);
+        releaser.join();
+
+        if (how == concurrent::shutdown_mode::drain) {
+            EXPECT_EQ(counter.load(), 100);
+            EXPECT_TRUE(dropped.empty());
+        }
+        else {
+            EXPECT_EQ(dropped.size(), 100u);
+            for (auto handle : dropped) {
+                handle.destroy();
+            }
+        }
+        EXPECT_EQ(pool.size(), 0u);
+        auto late = bump(counter).handle;
+        EXPECT_THROW(pool.submit(late), std::runtime_error);
+        late.destroy();
+    }
+}
+
+// --- 10. 工作线程统计: 开启后计数随调度增长, 关闭时只报告 active ---
+struct statistics_constants {
+    static constexpr bool WORKSTEAL_STATISTICS = true;
+};
+
+using StatisticsExecutor  = thread_pool_executor<concurrent::segmented_queue<>, statistics_constants>;
+using StatisticsScheduler = scheduler<StatisticsExecutor>;
+
+TEST(ConcurrentTest, WorkerStatistics) {
+    StatisticsExecutor exec{ 2 };
+    auto env = make_environment(StatisticsScheduler{ exec });
+    auto test = [](auto env) -> task<int, StatisticsExecutor, StatisticsScheduler> {
+        co_return co_await fib<StatisticsExecutor>(co_await context(), 12);
+        }(env);
+    EXPECT_EQ(test.get_result(), 144);
+
+    auto stats = exec.get_thread_pool().stats();
+    ASSERT_EQ(stats.size(), 2u);
+    std::size_t resumed = 0, global_taken = 0;
+    for (auto& s : stats) {
+        EXPECT_TRUE(s.active);
+        EXPECT_LE(s.local_high_water, 32u);
+        resumed      += s.resumed;
+        global_taken += s.global_taken;
+    }
+    EXPECT_GT(resumed, 0u);
+    EXPECT_GT(global_taken, 0u);
+
+    // 默认关闭: 计数被编译掉
+    ShutdownPool pool(1);
+    for (auto& s : pool.stats()) {
+        EXPECT_EQ(s.resumed, 0u);
+    }
+}
+
+// --- 11. EDF 执行器: 截止时间早的先执行, fork 继承父协程的截止时间 ---
+using EdfScheduler = scheduler<edf_executor>;
+
+// 挂起后把句柄交给测试, 由测试决定何时重新提交
+struct park_awaiter {
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(handle_type handle) noexcept {
+        *slot_ = handle;
+        parked_->count_down();
+    }
+    void await_resume() const noexcept {}
+
+    handle_type* slot_;
+    std::latch*  parked_;
+};
+
+TEST(ConcurrentTest, EdfExecutorRunsEarliestDeadlineFirst) {
+    edf_executor exec{ 1 };
+    auto env = make_environment(EdfScheduler{ exec });
+    std::latch parked(3), started(1), release(1);
+    std::mutex mtx;
+    std::vector<int> order;
+    handle_type handles[3];
+
+    // 截止时间与创建顺序相反, 设置后挂起
+    auto now = std::chrono::steady_clock::now();
+    std::vector<task<void, edf_executor, EdfScheduler>> tasks;
+    for (int i = 0; i < 3; i++) {
+        tasks.push_back([](auto env, int i, auto deadline, park_awaiter park, auto& mtx, auto& order) -> task<void, edf_executor, EdfScheduler> {
+            co_await this_task::set_deadline(deadline);
+            co_await park;
+            std::lock_guard<std::mutex> guard(mtx);
+            order.push_back(i);
+            }(env, i, now + std::chrono::seconds(10 - i), park_awaiter{ &handles[i], &parked }, mtx, order));
+    }
+    parked.wait();
+
+    // 唯一的线程被占用时按创建顺序重新提交, 出队顺序由截止时间决定
+    auto blocker = [](auto env, std::latch& started, std::latch& release) -> task<void, edf_executor, EdfScheduler> {
+        started.count_down();
+        release.wait();
+        co_return;
+        }(env, started, release);
+    started.wait();
+    for (auto handle : handles) {
+        exec.execute(handle);
+    }
+    release.count_down();
+    blocker.join();
+    for (auto& t : tasks) t.join();
+    EXPECT_EQ(order, std::vector<int>({ 2, 1, 0 }));
+
+    auto inherit = [](auto env, auto deadline) -> task<bool, edf_executor, EdfScheduler> {
+        co_await this_task::set_deadline(deadline);
+        auto child = [](auto&&) -> coflux::fork<std::chrono::steady_clock::time_point, edf_executor> {
+            co_return co_await this_fork::get_deadline();
+            }(co_await context());
+        co_return co_await child == deadline;
+        }(env, now + std::chrono::seconds(5));
+    EXPECT_TRUE(inherit.get_result());
+}
+
+// --- 12. 分片执行器: 协程留在指定分片的线程上, 跨分片经 SPSC 环传递, 定时器由分片自己维护 ---
+using Shards        = sharded_executor<2>;
+using ShardScheduler = scheduler<Shards>;
+
+TEST(ConcurrentTest, ShardedExecutorCrossShard) {
+    auto env = make_environment(ShardScheduler{});
+    auto test = [](auto env) -> task<int, Shards::shard<0>, ShardScheduler> {
+        auto&& ctx = co_await context();
+        auto home = std::this_thread::get_id();
+
+        auto remote = [](auto&&, int i) -> coflux::fork<int, Shards::shard<1>> {
+            co_return i;
+            };
+
+        int sum = 0;
+        std::vector<coflux::fork<int, Shards::shard<1>>> forks;
+        for (int i = 0; i < 300; i++) {
+            forks.push_back(remote(ctx, i));
+        }
+        for (auto& f : forks) {
+            sum += co_await f;
+            EXPECT_EQ(std::this_thread::get_id(), home);
+        }
+        co_return sum;
+        }(env);
+    EXPECT_EQ(test.get_result(), 299 * 300 / 2);
+
+    Shards shards;
+    std::atomic_int counter = 0;
+    auto start = std::chrono::steady_clock::now();
+    shards.get<1>().execute_after(bump(counter).handle, std::chrono::milliseconds(20));
+    while (counter.load() == 0 && std::chrono::steady_clock::now() - start < std::chrono::seconds(5)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(counter.load(), 1);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+}
+
+// --- 13. 批量提交: 队列的 enqueue_bulk 保序, 执行器的 execute_bulk 一次交付整批句柄 ---
+TEST(ConcurrentTest, BulkSubmission) {
+    concurrent::unbounded_queue<> queue;
+    int values[100];
+    std::vector<handle_type> batch;
+    for (auto& v : values) {
+        batch.push_back(as_handle(v));
+    }
+    queue.enqueue_bulk(batch.begin(), batch.size());
+    EXPECT_EQ(queue.size_approx(), 100u);
+    for (auto expected : batch) {
+        EXPECT_EQ(queue.try_dequeue(), expected);
+    }
+
+    static_assert(executive_bulk<thread_pool_executor<>>);
+    static_assert(!executive_bulk<noop_executor>);
+
+    auto run_bulk = [](auto exec) {
+        using traits = detail::executor_traits<decltype(exec)>;
+        std::atomic_int counter = 0;
+        std::vector<handle_type> handles;
+        for (int i = 0; i < 10000; i++) {
+            handles.push_back(bump(counter).handle);
+        }
+        traits::execute_bulk(&exec, handles);
+        auto start = std::chrono::steady_clock::now();
+        while (counter.load() < 10000 && std::chrono::steady_clock::now() - start < std::chrono::seconds(10)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return counter.load();
+        };
+    EXPECT_EQ(run_bulk(thread_pool_executor<>{ 2 }), 10000);
+    EXPECT_EQ(run_bulk(thread_pool_executor<concurrent::unbounded_queue<>>{ 2 }), 10000);
+    EXPECT_EQ(run_bulk(noop_executor{}), 10000);
+}
+
+// --- 14. 对称转移: 子协程在父协程执行器的线程上结束时直接切回父协程, 不再经过执行器 ---
+template <bool Affine>
+struct counting_executor {
+    struct state {
+        concurrent::worker_thread<> thread;
+        std::atomic_int             executed = 0;
+    };
+
+    void execute(handle_type handle) {
+        state_->executed.fetch_add(1, std::memory_order_relaxed);
+        state_->thread.submit(handle);
+    }
+
+    bool running_in_this_thread() const noexcept requires Affine {
+        return state_->thread.running_in_this_thread();
+    }
+
+    std::shared_ptr<state> state_ = std::make_shared<state>();
+};
+
+template <bool Affine>
+int count_executions(int n) {
+    using Exec = counting_executor<Affine>;
+    using Sched = scheduler<Exec>;
+    Exec exec;
+    auto env = make_environment(Sched{ exec });
+    auto test = [](auto env, int n) -> task<int, Exec, Sched> {
+        auto&& ctx = co_await context();
+        std::vector<coflux::fork<int, Exec>> forks;
+        for (int i = 0; i < n; i++) {
+            // 先让出一次, 保证父协程已挂起等待
+            forks.push_back([](auto&&, int i) -> coflux::fork<int, Exec> {
+                co_await this_fork::yield();
+                co_return i;
+                }(ctx, i));
+        }
+        int sum = 0;
+        for (auto& f : forks) {
+            sum += co_await f;
+        }
+        co_return sum;
+        }(env, n);
+    EXPECT_EQ(test.get_result(), n * (n - 1) / 2);
+    return exec.state_->executed.load();
+}
+
+TEST(ConcurrentTest, SymmetricTransferSkipsExecutor) {
+    static_assert(executive_affine<counting_executor<true>>);
+    static_assert(!executive_affine<counting_executor<false>>);
+    static_assert(executive_affine<thread_pool_executor<>>);
+
+    constexpr int N = 100;
+    // 单线程上只剩根任务与每个子协程的首次调度和让出, 父协程的恢复全部经由对称转移
+    EXPECT_EQ(count_executions<true>(N), 1 + 2 * N);
+    EXPECT_GT(count_executions<false>(N), 1 + 2 * N);
+}
+
+// --- 15. 协作预算: 总是就绪的 await 用完预算后也会让出工作线程 ---
+struct coop_constants {
+    static constexpr std::size_t COOPERATIVE_BUDGET = 8;
+};
+
+template <typename Executor>
+bool other_runs_before_loop_ends() {
+    using Sched = scheduler<Executor>;
+    auto env = make_environment(Sched{ Executor{ 1 } });
+    auto test = [](auto env) -> task<bool, Executor, Sched> {
+        std::atomic_bool other_ran = false;
+        auto other = [](auto&&, std::atomic_bool& other_ran) -> coflux::fork<void, Executor> {
+            other_ran = true;
+            co_return;
+            }(co_await context(), other_ran);
+        // 有界通道的读写总能立即完成, 不会自然挂起
+        channel<int[4]> chan;
+        int value = 0;
+        for (int i = 0; i < 1000 && !other_ran.load(); i++) {
+            co_await (chan << i);
+            co_await (chan >> value);
+        }
+        co_return other_ran.load();
+        }(env);
+    return test.get_result();
+}
+
+TEST(ConcurrentTest, CooperativeBudgetYieldsReadyAwaits) {
+    // 单线程: 不设预算时另一个协程只能等循环结束, 设了预算则中途就能执行
+    EXPECT_FALSE(other_runs_before_loop_ends<thread_pool_executor<>>());
+    EXPECT_TRUE((other_runs_before_loop_ends<thread_pool_executor<concurrent::segmented_queue<>, coop_constants>>()));
+}
+
+// --- 16. 阻塞执行器: 阻塞调用移出工作线程, 线程按需增减, 队列满时拒绝 ---
+TEST(ConcurrentTest, BlockingExecutorIsElastic) {
+    using Pool = thread_pool_executor<>;
+    using Sched = scheduler<Pool, blocking_executor>;
+    blocking_executor blocking{ 2, 1, std::chrono::milliseconds(50) };
+    auto env = make_environment(Sched{ Pool{ 1 }, blocking });
+
+    // 阻塞期间唯一的工作线程仍能执行其他协程
+    std::latch release(1);
+    auto test = [](auto env, std::latch& release) -> task<bool, Pool, Sched> {
+        auto&& ctx = co_await context();
+        auto home = std::this_thread::get_id();
+        auto blocker = [](auto&&, std::latch& release, std::thread::id home) -> coflux::fork<bool, Pool> {
+            auto& sch = co_await get_scheduler();
+            co_await this_fork::dispatch(&sch.template get<blocking_executor>());
+            bool moved = std::this_thread::get_id() != home;
+            release.wait();
+            co_await this_fork::dispatch(&sch.template get<Pool>());
+            co_return moved && std::this_thread::get_id() == home;
+            }(ctx, release, home);
+        auto other = [](auto&&, std::latch& release) -> coflux::fork<void, Pool> {
+            release.count_down();
+            co_return;
+            }(ctx, release);
+        co_await other;
+        co_return co_await blocker;
+        }(env, release);
+    EXPECT_TRUE(test.get_result());
+
+    auto& pool = blocking.get_blocking_pool();
+    std::latch started(2), unblock(1);
+    std::atomic_int counter = 0;
+    blocking.execute(block(started, unblock).handle);
+    blocking.execute(block(started, unblock).handle);
+    started.wait();
+    EXPECT_EQ(pool.size(), 2u);
+    blocking.execute(bump(counter).handle);
+    EXPECT_EQ(pool.queue_size(), 1u);
+    auto rejected = bump(counter).handle;
+    EXPECT_THROW(blocking.execute(rejected), std::runtime_error);
+    rejected.destroy();
+
+    unblock.count_down();
+    auto start = std::chrono::steady_clock::now();
+    while ((counter.load() < 1 || pool.size() != 0) && std::chrono::steady_clock::now() - start < std::chrono::seconds(5)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(counter.load(), 1);
+    EXPECT_EQ(pool.size(), 0u);
+}
+
+// --- 17. worker_group 作为执行器: 协程固定在哈希到的工作线程上, 该线程积压时改投另一个候选 ---
+TEST(ConcurrentTest, WorkerGroupDispatchesByLoad) {
+    using Group = worker_group<4>;
+    using Sched = scheduler<Group>;
+    auto env = make_environment(Sched{});
+
+    auto test = [](auto env) -> task<bool, Group, Sched> {
+        auto home = std::this_thread::get_id();
+        for (int i = 0; i < 10; i++) {
+            co_await this_task::yield();
+            if (std::this_thread::get_id() != home) {
+                co_return false;
+            }
+        }
+        co_return true;
+        }(env);
+    EXPECT_TRUE(test.get_result());
+
+    // 堵住 0 号线程后逐个提交, 每次等其他线程清空: 0 号的积压不会超过 rebalance_slack + 1
+    Group group;
+    std::latch started(1), release(1);
+    std::atomic_int counter = 0;
+    group.get<0>().execute(block(started, release).handle);
+    started.wait();
+    constexpr int N = 200;
+    for (int i = 0; i < N; i++) {
+        group.execute(bump(counter).handle);
+        while (counter.load() + int(group.get<0>().size_approx()) < i + 1) {
+            std::this_thread::yield();
+        }
+    }
+    EXPECT_LE(group.get<0>().size_approx(), Group::rebalance_slack + 1);
+    release.count_down();
+    auto start = std::chrono::steady_clock::now();
+    while (counter.load() < N && std::chrono::steady_clock::now() - start < std::chrono::seconds(5)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(counter.load(), N);
+}
+
+// --- 18. 时间轮: 级联与溢出区间内的定时器按截止时间触发, 且不会提前 ---
+struct tiny_wheel_constants {
+    static constexpr std::size_t TIMING_WHEEL_SLOT_BITS = 2;
+    static constexpr std::size_t TIMING_WHEEL_LEVELS    = 2;
+};
+
+TEST(ConcurrentTest, TimingWheelFiresInDeadlineOrder) {
+    using clock = std::chrono::steady_clock;
+    // 每层 4 个槽, 两层只覆盖 16 个刻度, 更远的定时器先进入溢出链表再逐层级联
+    concurrent::timing_wheel<tiny_wheel_constants> wheel;
+    constexpr int N = 20;
+    std::vector<int> delays(N);
+    for (int i = 0; i < N; i++) {
+        delays[i] = 3 * (i + 1);
+    }
+    std::reverse(delays.begin() + N / 2, delays.end());
+    std::swap(delays[0], delays[N / 2]);
+
+    std::mutex mtx;
+    std::vector<int> order;
+    std::atomic_int early = 0;
+    std::latch fired(N);
+    for (int delay : delays) {
+        auto deadline = clock::now() + std::chrono::milliseconds(delay);
+        wheel.submit([&, delay, deadline] {
+            if (clock::now() < deadline) {
+                early++;
+            }
+            std::lock_guard<std::mutex> guard(mtx);
+            order.push_back(delay);
+            fired.count_down();
+            }, std::chrono::milliseconds(delay));
+    }
+    fired.wait();
+    EXPECT_EQ(early.load(), 0);
+    EXPECT_TRUE(std::is_sorted(order.begin(), order.end()));
+
+    // 以时间轮为后端的 timer_executor 同样支撑 sleep_for
+    using pool = thread_pool_executor<>;
+    using sche = scheduler<pool, timer_executor>;
+    auto env = make_environment(sche{ pool{ 2 }, timer_executor{ concurrent::timer_backend::wheel } });
+    auto slept = [](auto env) -> task<clock::duration, pool, sche> {
+        auto start = clock::now();
+        co_await this_task::sleep_for(std::chrono::milliseconds(20));
+        co_return clock::now() - start;
+        }(env);
+    EXPECT_GE(slept.get_result(), std::chrono::milliseconds(20));
+}
+
+// --- 19. 侵入式定时器节点: 由调用方持有, 两种后端都直接链入, 关闭时以 fire == false 交还 ---
+struct counting_timer_node : concurrent::timer_node {
+    counting_timer_node() {
+        invoke = [](concurrent::timer_node* node, bool fire) {
+            auto* self = static_cast<counting_timer_node*>(node);
+            (fire ? self->fired : self->dropped)++;
+        };
+    }
+
+    std::atomic_int fired   = 0;
+    std::atomic_int dropped = 0;
+};
+
+TEST(ConcurrentTest, IntrusiveTimerNodesAreLinkedInPlace) {
+    using clock = timer_executor::clock;
+    for (auto backend : { concurrent::timer_backend::heap, concurrent::timer_backend::wheel }) {
+        counting_timer_node soon, never;
+        {
+            timer_executor timer(backend);
+            timer.schedule(&soon, clock::now() + std::chrono::milliseconds(5));
+            timer.schedule(&never, clock::now() + std::chrono::hours(1));
+            auto start = clock::now();
+            while (soon.fired.load() == 0 && clock::now() - start < std::chrono::seconds(5)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        EXPECT_EQ(soon.fired.load(), 1);
+        EXPECT_EQ(soon.dropped.load(), 0);
+        EXPECT_EQ(never.fired.load(), 0);
+        EXPECT_EQ(never.dropped.load(), 1);
+    }
+}
+
+// --- 20. 工作线程自带定时器: 在线程池工作线程上发起的定时在同一线程触发, 池外则退回定时器线程 ---
+TEST(ConcurrentTest, WorkerLocalTimersFireOnTheSameWorker) {
+    using clock = std::chrono::steady_clock;
+    using pool = thread_pool_executor<>;
+    using sche = scheduler<pool, timer_executor>;
+
+    struct recording_node : concurrent::timer_node {
+        recording_node() {
+            invoke = [](concurrent::timer_node* node, bool fire) {
+                auto* self = static_cast<recording_node*>(node);
+                if (fire) {
+                    self->fired_on = std::this_thread::get_id();
+                    self->fired.count_down();
+                }
+            };
+        }
+
+        std::thread::id fired_on;
+        std::latch      fired{ 1 };
+    };
+
+    pool exec{ 2 };
+    auto env = make_environment(sche{ exec, timer_executor{} });
+    recording_node outside;
+    EXPECT_FALSE(exec.try_schedule_local(&outside, clock::now()));
+
+    auto t = [](auto env, pool& exec) -> task<bool, pool, sche> {
+        recording_node node;
+        std::thread::id scheduled_on = std::this_thread::get_id();
+        if (!exec.try_schedule_local(&node, clock::now() + std::chrono::milliseconds(5))) {
+            co_return false;
+        }
+        auto start = clock::now();
+        co_await this_task::sleep_for(std::chrono::milliseconds(10));
+        EXPECT_GE(clock::now() - start, std::chrono::milliseconds(10));
+        node.fired.wait();
+        co_return node.fired_on == scheduled_on;
+        }(env, exec);
+    EXPECT_TRUE(t.get_result());
+}
+
+// --- 21. 微秒级与绝对时间睡眠: 不提前醒来, 零或已过去的截止时间直接交还执行器 ---
+TEST(ConcurrentTest, SubMillisecondAndAbsoluteSleeps) {
+    using clock = std::chrono::steady_clock;
+
+    // 定时器线程(Linux 上由 timerfd 唤醒)
+    auto on_timer_thread = [](auto env) -> task<bool, noop_executor, scheduler<noop_executor, timer_executor>> {
+        bool on_time = true;
+        for (int i = 0; i < 20; i++) {
+            auto deadline = clock::now() + std::chrono::microseconds(200);
+            co_await this_task::sleep_until(deadline);
+            on_time = on_time && clock::now() >= deadline;
+            auto start = clock::now();
+            co_await this_task::sleep_for(std::chrono::microseconds(150));
+            on_time = on_time && clock::now() - start >= std::chrono::microseconds(150);
+        }
+        co_await this_task::sleep_until(clock::now() - std::chrono::seconds(1));
+        co_return on_time;
+        }(make_environment(scheduler<noop_executor, timer_executor>{}));
+    EXPECT_TRUE(on_timer_thread.get_result());
+
+    // 线程池工作线程自带的定时器
+    using pool = thread_pool_executor<>;
+    auto on_worker = [](auto env) -> task<bool, pool, scheduler<pool, timer_executor>> {
+        bool on_time = true;
+        for (int i = 0; i < 20; i++) {
+            auto deadline = clock::now() + std::chrono::microseconds(300);
+            co_await this_task::sleep_until(deadline);
+            on_time = on_time && clock::now() >= deadline;
+        }
+        co_await this_task::sleep_for(std::chrono::microseconds(0));
+        co_return on_time;
+        }(make_environment(scheduler<pool, timer_executor>{ pool{ 2 }, timer_executor{} }));
+    EXPECT_TRUE(on_worker.get_result());
+}
+
+// --- 22. 可取消的睡眠: 停止请求把节点从定时器中摘除, 睡眠者立即以取消状态结束 ---
+TEST(ConcurrentTest, CancelledSleepsReleaseTheirTimers) {
+    using clock = timer_executor::clock;
+
+    // 直接取消: 两种后端都只以 fire == false 交还一次, 不必等到关闭
+    for (auto backend : { concurrent::timer_backend::heap, concurrent::timer_backend::wheel }) {
+        counting_timer_node node;
+        {
+            timer_executor timer(backend);
+            timer.schedule(&node, clock::now() + std::chrono::hours(1));
+            EXPECT_TRUE(concurrent::cancel_timer(&node));
+            EXPECT_FALSE(concurrent::cancel_timer(&node));
+            auto start = clock::now();
+            while (node.dropped.load() == 0 && clock::now() - start < std::chrono::seconds(5)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            EXPECT_EQ(node.dropped.load(), 1);
+        }
+        EXPECT_EQ(node.fired.load(), 0);
+        EXPECT_EQ(node.dropped.load(), 1);
+    }
+
+    // when_any 的胜者出现后, 落败者的一小时睡眠被取消(工作线程自带定时器)
+    using pool = thread_pool_executor<>;
+    using sche = scheduler<pool, timer_executor>;
+    auto start = clock::now();
+    {
+        auto race = [](auto env) -> task<int, pool, sche> {
+            auto&& ctx = co_await context();
+            auto result = co_await when_any(
+                [](auto&&) -> coflux::fork<int, pool> { co_await std::chrono::milliseconds(10); co_return 1; }(ctx),
+                [](auto&&) -> coflux::fork<int, pool> { co_await std::chrono::hours(1); co_return 2; }(ctx)
+            );
+            co_return std::get<0>(result);
+            }(make_environment(sche{ pool{ 2 }, timer_executor{} }));
+        EXPECT_EQ(race.get_result(), 1);
+    }
+    EXPECT_LT(clock::now() - start, std::chrono::seconds(5));
+
+    // 已发出停止请求时睡眠不再挂起; 在定时器线程上睡眠的分支同样被唤醒并以 cancel_exception 结束
+    start = clock::now();
+    {
+        auto stopped = [](auto env) -> task<bool, noop_executor, scheduler<noop_executor, timer_executor>> {
+            auto&& ctx = co_await context();
+            auto sleeper = [](auto&&) -> coflux::fork<void, noop_executor> { co_await std::chrono::hours(1); }(ctx);
+            auto waker = [](auto&&) -> coflux::fork<void, noop_executor> { co_await std::chrono::milliseconds(10); }(ctx);
+            co_await waker;
+            co_await this_task::cancel();
+            co_return true;
+            }(make_environment(scheduler<noop_executor, timer_executor>{}));
+        EXPECT_THROW(stopped.get_result(), cancel_exception);
+    }
+    EXPECT_LT(clock::now() - start, std::chrono::seconds(5));
+}
+
+// --- 23. 定时器合并: 同一 slack 窗口内到期的睡眠共享一次唤醒, 并以一次 execute_bulk 交给执行器 ---
+struct bulk_recording_executor {
+    struct state {
+        std::atomic_int singles  = 0;
+        std::atomic_int bulks    = 0;
+        std::atomic_int max_bulk = 0;
+    };
+
+    void execute(handle_type handle) {
+        state_->singles.fetch_add(1);
+        handle.resume();
+    }
+
+    void execute_bulk(std::span<const handle_type> handles) {
+        state_->bulks.fetch_add(1);
+        int size = int(handles.size());
+        int seen = state_->max_bulk.load();
+        while (seen < size && !state_->max_bulk.compare_exchange_weak(seen, size)) {}
+        for (auto handle : handles) {
+            handle.resume();
+        }
+    }
+
+    std::shared_ptr<state> state_ = std::make_shared<state>();
+};
+
+coflux::fork<void, bulk_recording_executor> slack_sleeper(auto&&, std::chrono::steady_clock::duration delay,
+    std::chrono::steady_clock::duration slack, std::atomic_int& early) {
+    auto deadline = std::chrono::steady_clock::now() + delay;
+    co_await this_fork::sleep_for(delay, slack);
+    if (std::chrono::steady_clock::now() < deadline) {
+        early++;
+    }
+}
+
+TEST(ConcurrentTest, SlackCoalescesTimerWakeups) {
+    using clock = std::chrono::steady_clock;
+    using sche  = scheduler<bulk_recording_executor, timer_executor>;
+
+    // 向上取整到 slack 的整数倍: 不提前, 最多晚 slack
+    auto slack = std::chrono::milliseconds(10);
+    for (int i = 0; i < 100; i++) {
+        auto deadline  = clock::now() + std::chrono::microseconds(137 * i);
+        auto coalesced = concurrent::coalesce(deadline, slack);
+        EXPECT_GE(coalesced, deadline);
+        EXPECT_LT(coalesced - deadline, slack);
+        EXPECT_EQ(coalesced.time_since_epoch() % slack, clock::duration::zero());
+    }
+    EXPECT_EQ(concurrent::coalesce(clock::time_point(slack * 3), slack), clock::time_point(slack * 3));
+
+    auto launch = [](auto env, clock::duration slack, std::atomic_int& early) -> task<void, bulk_recording_executor, sche> {
+        auto&& ctx = co_await context();
+        for (int i = 0; i < 16; i++) {
+            slack_sleeper(ctx, std::chrono::microseconds(500 * i + 100), slack, early);
+        }
+        co_return;
+        };
+
+    // 每次睡眠各自给出 slack, 两种后端; 以及由 timer_executor 统一给出 slack
+    struct setup {
+        concurrent::timer_backend backend;
+        clock::duration           sleep_slack;
+        clock::duration           timer_slack;
+    };
+    for (auto [backend, sleep_slack, timer_slack] : {
+        setup{ concurrent::timer_backend::heap,  std::chrono::milliseconds(50), clock::duration::zero() },
+        setup{ concurrent::timer_backend::wheel, std::chrono::milliseconds(50), clock::duration::zero() },
+        setup{ concurrent::timer_backend::heap,  clock::duration::zero(),       std::chrono::milliseconds(50) } }) {
+        bulk_recording_executor exec;
+        std::atomic_int early = 0;
+        launch(make_environment(sche{ exec, timer_executor{ backend, timer_slack } }), sleep_slack, early).join();
+        EXPECT_EQ(early.load(), 0);
+        // 16 个睡眠最多落在两个 50ms 窗口里
+        EXPECT_LE(exec.state_->bulks.load(), 2);
+        EXPECT_GE(exec.state_->max_bulk.load(), 8);
+    }
+}
+
+// --- 24. 周期定时: 整个循环只用一个定时器节点, 按理想节拍重新调度, 睡过头的节拍计为错过 ---
+TEST(ConcurrentTest, IntervalTicksWithoutDrift) {
+    using clock = std::chrono::steady_clock;
+    using pool  = thread_pool_executor<>;
+    using sche  = scheduler<pool, timer_executor>;
+
+    struct report {
+        std::size_t ticks   = 0;
+        std::size_t missed  = 0;
+        std::size_t periods = 0;
+        bool        aligned = true;
+        bool        early   = false;
+    };
+
+    auto ticking = [](auto env) -> task<report, pool, sche> {
+        report r;
+        auto period = std::chrono::milliseconds(5);
+        auto ticker = co_await this_task::interval(period);
+        auto first  = ticker.next_tick();
+        for (int i = 0; i < 20; i++) {
+            auto due = ticker.next_tick();
+            std::size_t missed = co_await ticker;
+            r.early   = r.early || clock::now() < due;
+            r.aligned = r.aligned && (ticker.next_tick() - first) % period == clock::duration::zero();
+            r.missed += missed;
+            r.ticks++;
+            // 循环体本身的耗时不会让节拍漂移
+            std::this_thread::sleep_for(std::chrono::microseconds(i == 10 ? 17000 : 1000));
+        }
+        r.periods = std::size_t((ticker.next_tick() - first) / period);
+        co_return r;
+        }(make_environment(sche{ pool{ 2 }, timer_executor{} }));
+
+    report r = ticking.get_result();
+    EXPECT_FALSE(r.early);
+    EXPECT_TRUE(r.aligned);
+    EXPECT_EQ(r.ticks, 20u);
+    // 第 10 次节拍后睡了 17ms, 至少错过两个 5ms 节拍
+    EXPECT_GE(r.missed, 2u);
+    EXPECT_EQ(r.periods, r.ticks + r.missed);
+
+    // 停止请求同样取消正在等待的节拍
+    auto start = clock::now();
+    auto stopped = [](auto env, std::atomic_int& ticks) -> task<void, pool, sche> {
+        auto&& ctx = co_await context();
+        [](auto&&, std::atomic_int& ticks) -> coflux::fork<void, pool> {
+            auto ticker = co_await this_fork::interval(std::chrono::hours(1));
+            while (true) {
+                co_await ticker;
+                ticks++;
+            }
+            }(ctx, ticks);
+        co_await std::chrono::milliseconds(20);
+        co_await this_task::cancel();
+        };
+    std::atomic_int ticks = 0;
+    EXPECT_THROW(stopped(make_environment(sche{ pool{ 2 }, timer_executor{} }), ticks).get_result(), cancel_exception);
+    EXPECT_EQ(ticks.load(), 0);
+    EXPECT_LT(clock::now() - start, std::chrono::seconds(5));
+
+    auto invalid = [](auto env) -> task<void, pool, sche> {
+        auto ticker = co_await this_task::interval(std::chrono::milliseconds(0));
+        co_await ticker;
+        }(make_environment(sche{ pool{ 1 }, timer_executor{} }));
+    EXPECT_THROW(invalid.get_result(), std::runtime_error);
+}
+
+// --- 25. 周期定时的取消: 一直落后于节拍的循环从不挂起, 停止请求也要在就绪路径上生效 ---
+TEST(ConcurrentTest, LateIntervalLoopIsCancellable) {
+    using clock = std::chrono::steady_clock;
+    using pool  = thread_pool_executor<>;
+    using sche  = scheduler<pool, timer_executor, new_thread_executor>;
+
+    auto start = clock::now();
+    auto stopped = [](auto env, std::atomic_int& ticks) -> task<void, pool, sche> {
+        auto&& ctx = co_await context();
+        // 循环独占自己的线程, 父任务的睡眠不会被它饿死
+        [](auto&&, std::atomic_int& ticks) -> coflux::fork<void, new_thread_executor> {
+            auto ticker = co_await this_fork::interval(std::chrono::microseconds(100));
+            while (true) {
+                co_await ticker;
+                ticks++;
+                // 循环体总比周期长, 每个节拍都已过期
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            }(ctx, ticks);
+        co_await std::chrono::milliseconds(20);
+        co_await this_task::cancel();
+        };
+    std::atomic_int ticks = 0;
+    EXPECT_THROW(stopped(make_environment(sche{ pool{ 2 }, timer_executor{}, new_thread_executor{} }), ticks).get_result(), cancel_exception);
+    EXPECT_GT(ticks.load(), 0);
+    EXPECT_LT(clock::now() - start, std::chrono::seconds(5));
+}
+
+// --- 26. 批量窃取: 一次从受害者的本地队列拿走约一半, 句柄既不重复也不丢失 ---
+struct steal_constants {
+    static constexpr std::size_t WORKSTEAL_LOCAL_QUEUE_CAPACITY = 64;
+    static constexpr std::size_t WORKSTEAL_LIFO_SLOT_BUDGET     = 0;
+    static constexpr bool        WORKSTEAL_STATISTICS           = true;
+};
+
+using StealPool = concurrent::thread_pool<concurrent::unbounded_queue<>, steal_constants>;
+
+// 先在 latch 上会合, 保证 body 运行时每个参与者各占一个工作线程
+static bare_coroutine on_worker(std::latch& together, std::function<void()> body) {
+    together.arrive_and_wait();
+    body();
+    co_return;
+}
+
+static bare_coroutine record(std::atomic_int& runs, std::thread::id& ran_on, std::atomic_int& total) {
+    ran_on = std::this_thread::get_id();
+    runs.fetch_add(1);
+    total.fetch_add(1);
+    co_return;
+}
+
+TEST(ConcurrentTest, StealHalfMovesABatch) {
+    constexpr int n = 32;
+    StealPool pool(2);
+    std::latch together(2);
+    std::array<std::atomic_int, n> runs{};
+    std::array<std::thread::id, n> ran_on{};
+    std::atomic_int  total = 0;
+    std::atomic_bool submitted = false;
+    std::thread::id  victim;
+
+    // 受害者把任务全部压进自己的本地队列后一直占着线程, 另一个工作线程只能去偷
+    pool.submit(on_worker(together, [&]() {
+        victim = std::this_thread::get_id();
+        for (int i = 0; i < n; i++) {
+            pool.submit(record(runs[i], ran_on[i], total).handle);
+        }
+        submitted = true;
+        while (total.load() < n) {
+            std::this_thread::yield();
+        }
+        }).handle);
+    pool.submit(on_worker(together, [&]() {
+        while (!submitted.load()) {
+            std::this_thread::yield();
+        }
+        }).handle);
+
+    while (total.load() < n) {
+        std::this_thread::yield();
+    }
+    auto stats = pool.stats();
+    EXPECT_TRUE(pool.shutdown(concurrent::shutdown_mode::drain).empty());
+    for (int i = 0; i < n; i++) {
+        EXPECT_EQ(runs[i].load(), 1);
+        EXPECT_NE(ran_on[i], victim);
+    }
+    // 起步时两个会合协程之间最多还有一次窃取, 偷得最多的那个才是窃贼
+    auto& thief = *std::max_element(stats.begin(), stats.end(), [](auto& a, auto& b) { return a.steals < b.steals; });
+    // 逐个窃取要偷 n 次, 对半窃取只需 log(n) 次左右; 第一次就搬走剩余的一半
+    EXPECT_GE(thief.steals, 1u);
+    EXPECT_LT(thief.steals, std::size_t(n / 2));
+    EXPECT_GE(thief.local_high_water, std::size_t(n / 4));
+    EXPECT_LE(thief.local_high_water, std::size_t(n / 2));
+}
+
+// --- 27. 工作线程内提交: 留在自己的本地队列; 有空闲线程、只有一个线程、重投正在运行的句柄时退回全局队列 ---
+// 数一数有多少句柄进了全局队列
+struct counting_queue : public concurrent::unbounded_queue<> {
+    using concurrent::unbounded_queue<>::unbounded_queue;
+
+    template <typename Ref>
+    void enqueue(Ref&& value) {
+        enqueued.fetch_add(1);
+        concurrent::unbounded_queue<>::enqueue(std::forward<Ref>(value));
+    }
+
+    inline static std::atomic_int enqueued = 0;
+};
+
+using CountingPool = concurrent::thread_pool<counting_queue, steal_constants>;
+
+// 在挂起点把自己重新交给线程池, 此时工作线程的 running_ 仍是这个句柄
+struct resubmit_self {
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        // 提交之后协程可能已在别处恢复, 只能通过局部变量访问外部状态
+        bool* global = global_;
+        int before = counting_queue::enqueued.load();
+        pool_->submit(handle);
+        *global = counting_queue::enqueued.load() != before;
+    }
+
+    void await_resume() const noexcept {}
+
+    CountingPool* pool_;
+    bool*         global_;
+};
+
+static bare_coroutine resubmitting(CountingPool& pool, bool& global, std::atomic_int& resumed) {
+    co_await resubmit_self{ &pool, &global };
+    resumed.fetch_add(1);
+}
+
+TEST(ConcurrentTest, WorkerSubmitStaysLocal) {
+    std::atomic_int counter = 0;
+    // 在工作线程里提交一个句柄, 返回它是否进了全局队列
+    auto submit_from_worker = [&](CountingPool& pool) {
+        int before = counting_queue::enqueued.load();
+        pool.submit(bump(counter).handle);
+        return counting_queue::enqueued.load() != before;
+    };
+
+    // 两个工作线程都在忙: 进本地队列
+    {
+        CountingPool pool(2);
+        std::latch together(2);
+        std::atomic_bool done = false;
+        bool global = true;
+        pool.submit(on_worker(together, [&]() {
+            global = submit_from_worker(pool);
+            done = true;
+            }).handle);
+        pool.submit(on_worker(together, [&]() {
+            while (!done.load()) {
+                std::this_thread::yield();
+            }
+            }).handle);
+        EXPECT_TRUE(pool.shutdown(concurrent::shutdown_mode::drain).empty());
+        EXPECT_FALSE(global);
+    }
+
+    // 另一个工作线程空闲: 进全局队列好叫醒它
+    {
+        CountingPool pool(2);
+        std::latch alone(1);
+        std::atomic_bool done = false;
+        bool global = false;
+        pool.submit(on_worker(alone, [&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            global = submit_from_worker(pool);
+            done = true;
+            }).handle);
+        // 关闭会叫醒空闲线程, 要等提交完成
+        while (!done.load()) {
+            std::this_thread::yield();
+        }
+        EXPECT_TRUE(pool.shutdown(concurrent::shutdown_mode::drain).empty());
+        EXPECT_TRUE(global);
+    }
+
+    // 只有一个工作线程: 进全局队列
+    {
+        CountingPool pool(1);
+        std::latch alone(1);
+        bool global = false;
+        pool.submit(on_worker(alone, [&]() {
+            global = submit_from_worker(pool);
+            }).handle);
+        EXPECT_TRUE(pool.shutdown(concurrent::shutdown_mode::drain).empty());
+        EXPECT_TRUE(global);
+    }
+
+    // 重投正在运行的句柄 (另一个线程忙着, 否则空闲规则先生效): 进全局队列
+    {
+        CountingPool pool(2);
+        std::latch together(2);
+        std::atomic_int resumed = 0;
+        bool global = false;
+        pool.submit(on_worker(together, [&]() {
+            while (!resumed.load()) {
+                std::this_thread::yield();
+            }
+            }).handle);
+        together.arrive_and_wait();
+        pool.submit(resubmitting(pool, global, resumed).handle);
+        while (!resumed.load()) {
+            std::this_thread::yield();
+        }
+        EXPECT_TRUE(pool.shutdown(concurrent::shutdown_mode::drain).empty());
+        EXPECT_TRUE(global);
+    }
+
+    EXPECT_EQ(counter.load(), 3);
+}
+
+// --- 28. LIFO 槽: 最新提交的句柄先于本地队列里更早的句柄运行, 被挤出槽的句柄进本地队列而不丢失 ---
+using LifoPool = concurrent::thread_pool<concurrent::unbounded_queue<>, concurrent::default_thread_pool_constants>;
+
+static bare_coroutine note(std::vector<int>& order, std::atomic_int& ran, int id) {
+    order.push_back(id);
+    ran.fetch_add(1);
+    co_return;
+}
+
+TEST(ConcurrentTest, LifoSlotRunsNewestFirst) {
+    // 单独的工作线程对象: 每次压入都把槽里的旧句柄挤进本地队列
+    {
+        LifoPool::thread_type worker;
+        int a = 0, b = 0, c = 0;
+        EXPECT_FALSE(worker.try_push_local(as_handle(a)));
+        EXPECT_FALSE(worker.try_push_local(as_handle(b)));
+        EXPECT_FALSE(worker.try_push_local(as_handle(c)));
+        std::vector<handle_type> left;
+        worker.drop_local(left);
+        EXPECT_EQ(left, (std::vector<handle_type>{ as_handle(a), as_handle(b), as_handle(c) }));
+    }
+
+    // 线程池: 另一个工作线程忙着不来偷, 三个句柄都在提交者的线程上按 3, 2, 1 运行
+    LifoPool pool(2);
+    std::latch together(2);
+    std::atomic_int  ran = 0;
+    std::vector<int> order;
+    pool.submit(on_worker(together, [&]() {
+        for (int id = 1; id <= 3; id++) {
+            pool.submit(note(order, ran, id).handle);
+        }
+        }).handle);
+    pool.submit(on_worker(together, [&]() {
+        while (ran.load() < 3) {
+            std::this_thread::yield();
+        }
+        }).handle);
+    EXPECT_TRUE(pool.shutdown(concurrent::shutdown_mode::drain).empty());
+    EXPECT_EQ(order, (std::vector<int>{ 3, 2, 1 }));
+}
+
+// --- 29. drain 关闭: 工作线程自带定时器里没到期的睡眠被取消, 睡眠者在退出前以取消状态展开 ---
+TEST(ConcurrentTest, DrainCancelsWorkerLocalSleeps) {
+    using clock = std::chrono::steady_clock;
+    using pool  = thread_pool_executor<>;
+    using sche  = scheduler<pool, timer_executor>;
+
+    struct unwind_guard {
+        ~unwind_guard() {
+            unwound = true;
+        }
+
+        std::atomic_bool& unwound;
+    };
+
+    pool exec{ 2 };
+    std::atomic_bool unwound = false;
+    auto sleeper = [](auto env, std::atomic_bool& unwound) -> task<void, pool, sche> {
+        unwind_guard guard{ unwound };
+        co_await this_task::sleep_for(std::chrono::hours(1));
+        }(make_environment(sche{ exec, timer_executor{} }), unwound);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    auto start = clock::now();
+    EXPECT_TRUE(exec.get_thread_pool().shutdown(concurrent::shutdown_mode::drain).empty());
+    EXPECT_LT(clock::now() - start, std::chrono::seconds(5));
+    EXPECT_TRUE(unwound.load());
+    EXPECT_THROW(sleeper.get_result(), cancel_exception);
+}
+
+// --- 30. 分片上的睡眠: 由所在分片自己的定时器维护, 可从任意线程取消 ---
+TEST(ConcurrentTest, ShardSleepsStayOnTheShard) {
+    using clock = std::chrono::steady_clock;
+    using sche  = scheduler<Shards, timer_executor>;
+
+    Shards shards;
+    counting_timer_node outside;
+    EXPECT_FALSE(shards.get<0>().try_schedule_local(&outside, clock::now()));
+    EXPECT_FALSE(shards.try_schedule_local(&outside, clock::now()));
+
+    counting_timer_node soon, never;
+    auto t = [](auto env, Shards& shards, counting_timer_node& soon, counting_timer_node& never) -> task<bool, Shards::shard<0>, sche> {
+        auto home = std::this_thread::get_id();
+        // 只有所在的分片能接收节点
+        EXPECT_FALSE(shards.get<1>().try_schedule_local(&soon, clock::now()));
+        EXPECT_TRUE(shards.get<0>().try_schedule_local(&soon, clock::now() + std::chrono::milliseconds(5)));
+        EXPECT_TRUE(shards.try_schedule_local(&never, clock::now() + std::chrono::hours(1)));
+        auto start = clock::now();
+        co_await this_task::sleep_for(std::chrono::milliseconds(10));
+        EXPECT_GE(clock::now() - start, std::chrono::milliseconds(10));
+        co_return std::this_thread::get_id() == home && soon.fired.load() == 1;
+        }(make_environment(sche{ shards, timer_executor{} }), shards, soon, never);
+    EXPECT_TRUE(t.get_result());
+
+    // 池外线程取消分片上的节点: 分片自己摘除并以 fire == false 交还
+    EXPECT_TRUE(concurrent::cancel_timer(&never));
+    auto start = clock::now();
+    while (never.dropped.load() == 0 && clock::now() - start < std::chrono::seconds(5)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(never.dropped.load(), 1);
+    EXPECT_EQ(never.fired.load(), 0);
+
+    // 停止请求唤醒分片上的一小时睡眠
+    start = clock::now();
+    auto stopped = [](auto env) -> task<void, Shards::shard<1>, sche> {
+        auto&& ctx = co_await context();
+        [](auto&&) -> coflux::fork<void, Shards::shard<1>> { co_await std::chrono::hours(1); }(ctx);
+        co_await std::chrono::milliseconds(20);
+        co_await this_task::cancel();
+        };
+    EXPECT_THROW(stopped(make_environment(sche{ shards, timer_executor{} })).get_result(), cancel_exception);
+    EXPECT_LT(clock::now() - start, std::chrono::seconds(5));
+}
+
+// --- 31. abort 关闭: 工作线程在两次恢复之间就停下, 本地队列里没跑的句柄交还调用者 ---
+static bare_coroutine slow_bump(std::atomic_int& counter) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    counter.fetch_add(1);
+    co_return;
+}
+
+TEST(ConcurrentTest, AbortStopsBetweenLocalResumes) {
+    constexpr int n = 50;
+    StealPool pool(2);
+    std::latch together(2);
+    std::atomic_int  counter = 0;
+    std::atomic_bool stopping = false;
+    // 一个工作线程把 n 个慢任务压进本地队列, 另一个一直忙到关闭开始
+    pool.submit(on_worker(together, [&]() {
+        for (int i = 0; i < n; i++) {
+            pool.submit(slow_bump(counter).handle);
+        }
+        }).handle);
+    pool.submit(on_worker(together, [&]() {
+        while (!stopping.load()) {
+            std::this_thread::yield();
+        }
+        }).handle);
+    while (counter.load() == 0) {
+        std::this_thread::yield();
+    }
+    stopping = true;
+    auto dropped = pool.shutdown(concurrent::shutdown_mode::abort);
+    // 不再一口气跑完整轮 (最多 61 个) 本地句柄
+    EXPECT_LE(counter.load(), 5);
+    EXPECT_EQ(counter.load() + int(dropped.size()), n);
+    for (auto handle : dropped) {
+        handle.destroy();
+    }
+}
@@ -106,10 +106,13 @@ TEST(StructureTest, CancellationIsPropagated) {
 
     auto cancellable_fork = [&](auto&&, std::atomic<bool>& was_cancelled) -> coflux::fork<void, TestExecutor> {
         auto token = co_await coflux::this_fork::get_stop_token();
-        // 模拟一个长时工作
-        co_await std::chrono::milliseconds(200);
-        if (token.stop_requested()) {
-            was_cancelled.store(true);
+        // 模拟一个长时工作, 睡眠在取消时提前以 cancel_exception 醒来
+        try {
+            co_await std::chrono::milliseconds(200);
+        }
+        catch (const coflux::cancel_exception&) {
+            was_cancelled.store(token.stop_requested());
+            throw;
         }
         };
 